@@ -0,0 +1,96 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> allocations{ 0 };
+}
+
+// Replacing the global allocation functions
+void* operator new( std::size_t size ) {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if( void* p = std::malloc( size ? size : 1 ) )
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new( std::size_t size, std::nothrow_t const& ) noexcept {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    return std::malloc( size ? size : 1 );
+}
+void operator delete( void* p ) noexcept {
+    std::free( p );
+}
+void operator delete( void* p, std::size_t ) noexcept {
+    std::free( p );
+}
+void operator delete( void* p, std::nothrow_t const& ) noexcept {
+    std::free( p );
+}
+
+// The aligned forms too - e.g. std::pmr::new_delete_resource() always uses them
+void* operator new( std::size_t size, std::align_val_t alignment ) {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    auto const align = static_cast<std::size_t>( alignment );
+    // aligned_alloc needs a size that's a multiple of the alignment
+    if( void* p = std::aligned_alloc( align, ( ( size ? size : 1 ) + align - 1 ) / align * align ) )
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new( std::size_t size, std::align_val_t alignment, std::nothrow_t const& ) noexcept {
+    try {
+        return ::operator new( size, alignment );
+    }
+    catch( std::bad_alloc const& ) {
+        return nullptr;
+    }
+}
+void operator delete( void* p, std::align_val_t ) noexcept {
+    std::free( p );
+}
+void operator delete( void* p, std::size_t, std::align_val_t ) noexcept {
+    std::free( p );
+}
+void operator delete( void* p, std::align_val_t, std::nothrow_t const& ) noexcept {
+    std::free( p );
+}
+
+// And the array forms, forwarding to the ones above - the library's own array forms needn't
+// (e.g. a sanitizer runtime supplies its own, which would never be counted)
+void* operator new[]( std::size_t size ) {
+    return ::operator new( size );
+}
+void* operator new[]( std::size_t size, std::nothrow_t const& tag ) noexcept {
+    return ::operator new( size, tag );
+}
+void* operator new[]( std::size_t size, std::align_val_t alignment ) {
+    return ::operator new( size, alignment );
+}
+void* operator new[]( std::size_t size, std::align_val_t alignment, std::nothrow_t const& tag ) noexcept {
+    return ::operator new( size, alignment, tag );
+}
+void operator delete[]( void* p ) noexcept {
+    ::operator delete( p );
+}
+void operator delete[]( void* p, std::size_t size ) noexcept {
+    ::operator delete( p, size );
+}
+void operator delete[]( void* p, std::nothrow_t const& tag ) noexcept {
+    ::operator delete( p, tag );
+}
+void operator delete[]( void* p, std::align_val_t alignment ) noexcept {
+    ::operator delete( p, alignment );
+}
+void operator delete[]( void* p, std::size_t size, std::align_val_t alignment ) noexcept {
+    ::operator delete( p, size, alignment );
+}
+void operator delete[]( void* p, std::align_val_t alignment, std::nothrow_t const& tag ) noexcept {
+    ::operator delete( p, alignment, tag );
+}
+
+AllocationCounter::AllocationCounter() : m_start( allocations.load( std::memory_order_relaxed ) ) {}
+
+auto AllocationCounter::count() const -> std::size_t {
+    return allocations.load( std::memory_order_relaxed ) - m_start;
+}
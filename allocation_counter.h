@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts calls to the global operator new (from any thread) while it's alive,
+// e.g. to check that a conversion makes only the allocations we expect
+class AllocationCounter {
+    std::size_t m_start;
+public:
+    AllocationCounter();
+    auto count() const -> std::size_t;
+};
@@ -0,0 +1,383 @@
+#include "catch.hpp"
+#include "big_int.h"
+#include "int_to_string.h"
+#include "inserters.h"
+#include "string_column.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Cpp17 {
+
+    namespace {
+        using Limbs = std::vector<std::uint32_t>;
+
+        constexpr std::uint64_t limbBase = 1ull << 32;
+        constexpr std::uint32_t leafDivisor = 1000000000; // 10^9 - the most decimal digits that fit in a limb
+        constexpr std::size_t leafDigits = 9;
+        constexpr std::size_t leafLimbs = 16; // below this, dividing by 10^9 limb by limb beats splitting further
+
+        auto leading_zeros( std::uint32_t limb ) -> unsigned {
+            return 32 - static_cast<unsigned>( detail::bit_width( limb ) );
+        }
+
+        // limbs << shift (shift < 32), with one more limb on the end for what shifts out of the top
+        auto shifted_left( Limbs const& limbs, unsigned shift ) -> Limbs {
+            Limbs result( limbs.size() + 1 );
+            std::uint32_t carry = 0;
+            for( std::size_t i = 0; i < limbs.size(); ++i ) {
+                result[i] = ( limbs[i] << shift ) | carry;
+                carry = shift == 0 ? 0 : limbs[i] >> ( 32 - shift );
+            }
+            result.back() = carry;
+            return result;
+        }
+
+        // Divides limbs by divisor in place, returning the remainder.
+        // Inlined, so that for a constant divisor (10^9, at the leaves) the divisions become multiplies
+        inline auto divide_in_place( Limbs& limbs, std::uint32_t divisor ) -> std::uint32_t {
+            std::uint64_t remainder = 0;
+            for( std::size_t i = limbs.size(); i-- > 0; ) {
+                std::uint64_t const current = ( remainder << 32 ) | limbs[i];
+                limbs[i] = static_cast<std::uint32_t>( current / divisor );
+                remainder = current % divisor;
+            }
+            while( !limbs.empty() && limbs.back() == 0 )
+                limbs.pop_back();
+            return static_cast<std::uint32_t>( remainder );
+        }
+
+        // Appends exactly width digits of chunk, zero padded
+        void append_padded( std::string& text, std::uint32_t chunk, std::size_t width ) {
+            char digits[leafDigits];
+            for( std::size_t i = leafDigits; i-- > 0; chunk /= 10 )
+                digits[i] = static_cast<char>( '0' + chunk % 10 );
+            text.append( digits + leafDigits - width, width );
+        }
+
+        // Appends value's digits - exactly width of them, zero padded, unless width is 0
+        void append_decimal( std::string& text, BigUint const& value, std::size_t width, std::vector<BigUint> const& powers ) {
+            std::size_t const size = value.limbs().size();
+            if( size <= leafLimbs ) {
+                // Nine digits at a time, least significant first
+                Limbs limbs = value.limbs();
+                std::uint32_t chunks[leafLimbs * 32 / 29 + 2]; // 10^9 > 2^29
+                std::size_t count = 0;
+                while( !limbs.empty() )
+                    chunks[count++] = divide_in_place( limbs, leafDivisor );
+
+                std::size_t const digits = count == 0 ? 0 : ( count - 1 ) * leafDigits + decimal_digits( chunks[count - 1] );
+                if( width > digits )
+                    text.append( width - digits, '0' );
+                if( count > 0 ) {
+                    append_padded( text, chunks[count - 1], decimal_digits( chunks[count - 1] ) );
+                    for( std::size_t i = count - 1; i-- > 0; )
+                        append_padded( text, chunks[i], leafDigits );
+                }
+                return;
+            }
+
+            // The biggest power, 10^(9 * 2^k), with no more than about half the limbs
+            std::size_t k = 0;
+            while( k + 1 < powers.size() && powers[k + 1].limbs().size() * 2 <= size + 1 )
+                ++k;
+            std::size_t const lowDigits = leafDigits << k;
+            auto [high, low] = divmod( value, powers[k] );
+            if( high.is_zero() )
+                append_decimal( text, low, width, powers );
+            else {
+                append_decimal( text, high, width > lowDigits ? width - lowDigits : 0, powers );
+                append_decimal( text, low, lowDigits, powers );
+            }
+        }
+    }
+
+    auto BigUint::bit_width() const noexcept -> std::size_t {
+        return m_limbs.empty() ? 0 : ( m_limbs.size() - 1 ) * 32 + detail::bit_width( m_limbs.back() );
+    }
+
+    auto BigUint::operator+=( BigUint const& other ) -> BigUint& {
+        if( m_limbs.size() < other.m_limbs.size() )
+            m_limbs.resize( other.m_limbs.size() );
+        std::uint64_t carry = 0;
+        for( std::size_t i = 0; i < m_limbs.size(); ++i ) {
+            if( i >= other.m_limbs.size() && carry == 0 )
+                break;
+            std::uint64_t const sum = std::uint64_t( m_limbs[i] ) + ( i < other.m_limbs.size() ? other.m_limbs[i] : 0 ) + carry;
+            m_limbs[i] = static_cast<std::uint32_t>( sum );
+            carry = sum >> 32;
+        }
+        if( carry != 0 )
+            m_limbs.push_back( static_cast<std::uint32_t>( carry ) );
+        return *this;
+    }
+
+    auto BigUint::operator-=( BigUint const& other ) -> BigUint& {
+        std::int64_t borrow = 0;
+        for( std::size_t i = 0; i < m_limbs.size(); ++i ) {
+            if( i >= other.m_limbs.size() && borrow == 0 )
+                break;
+            std::int64_t const difference = std::int64_t( m_limbs[i] ) - ( i < other.m_limbs.size() ? other.m_limbs[i] : 0 ) - borrow;
+            m_limbs[i] = static_cast<std::uint32_t>( difference );
+            borrow = difference < 0 ? 1 : 0;
+        }
+        trim();
+        return *this;
+    }
+
+    auto operator*( BigUint const& lhs, BigUint const& rhs ) -> BigUint {
+        if( lhs.is_zero() || rhs.is_zero() )
+            return {};
+        auto const& a = lhs.m_limbs;
+        auto const& b = rhs.m_limbs;
+        Limbs product( a.size() + b.size() );
+        for( std::size_t i = 0; i < a.size(); ++i ) {
+            std::uint64_t carry = 0;
+            for( std::size_t j = 0; j < b.size(); ++j ) {
+                // (2^32 - 1)^2 + 2 (2^32 - 1) is exactly 2^64 - 1, so this can't overflow
+                std::uint64_t const t = std::uint64_t( a[i] ) * b[j] + product[i + j] + carry;
+                product[i + j] = static_cast<std::uint32_t>( t );
+                carry = t >> 32;
+            }
+            product[i + b.size()] = static_cast<std::uint32_t>( carry );
+        }
+        return BigUint( std::move( product ) );
+    }
+
+    auto compare( BigUint const& lhs, BigUint const& rhs ) noexcept -> int {
+        if( lhs.m_limbs.size() != rhs.m_limbs.size() )
+            return lhs.m_limbs.size() < rhs.m_limbs.size() ? -1 : 1;
+        for( std::size_t i = lhs.m_limbs.size(); i-- > 0; ) {
+            if( lhs.m_limbs[i] != rhs.m_limbs[i] )
+                return lhs.m_limbs[i] < rhs.m_limbs[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // Long division, a limb at a time (Knuth's Algorithm D, TAOCP vol 2, 4.3.1)
+    auto divmod( BigUint const& dividend, BigUint const& divisor ) -> std::pair<BigUint, BigUint> {
+        if( compare( dividend, divisor ) < 0 )
+            return { BigUint(), dividend };
+        if( divisor.m_limbs.size() == 1 ) {
+            Limbs quotient = dividend.m_limbs;
+            std::uint32_t const remainder = divide_in_place( quotient, divisor.m_limbs[0] );
+            return { BigUint( std::move( quotient ) ), BigUint( remainder ) };
+        }
+
+        // Shifted so the divisor's top bit is set - then each estimated quotient limb is at most 2 too big
+        unsigned const shift = leading_zeros( divisor.m_limbs.back() );
+        Limbs const v = [&] { auto limbs = shifted_left( divisor.m_limbs, shift ); limbs.pop_back(); return limbs; }();
+        Limbs u = shifted_left( dividend.m_limbs, shift );
+        std::size_t const n = v.size();
+        std::size_t const m = dividend.m_limbs.size() - n;
+        Limbs quotient( m + 1 );
+
+        for( std::size_t j = m + 1; j-- > 0; ) {
+            std::uint64_t const top = ( std::uint64_t( u[j + n] ) << 32 ) | u[j + n - 1];
+            std::uint64_t estimate = top / v[n - 1];
+            std::uint64_t rest = top % v[n - 1];
+            while( estimate >= limbBase || estimate * v[n - 2] > ( ( rest << 32 ) | u[j + n - 2] ) ) {
+                --estimate;
+                rest += v[n - 1];
+                if( rest >= limbBase )
+                    break;
+            }
+
+            // u -= estimate * v, at limb j
+            std::int64_t borrow = 0;
+            for( std::size_t i = 0; i < n; ++i ) {
+                std::uint64_t const product = estimate * v[i];
+                std::int64_t const t = std::int64_t( u[i + j] ) - borrow - std::int64_t( product & 0xFFFFFFFF );
+                u[i + j] = static_cast<std::uint32_t>( t );
+                borrow = std::int64_t( product >> 32 ) - ( t >> 32 );
+            }
+            std::int64_t const t = std::int64_t( u[j + n] ) - borrow;
+            u[j + n] = static_cast<std::uint32_t>( t );
+
+            // Rarely, still one too big - add one v back
+            if( t < 0 ) {
+                --estimate;
+                std::uint64_t carry = 0;
+                for( std::size_t i = 0; i < n; ++i ) {
+                    std::uint64_t const sum = std::uint64_t( u[i + j] ) + v[i] + carry;
+                    u[i + j] = static_cast<std::uint32_t>( sum );
+                    carry = sum >> 32;
+                }
+                u[j + n] += static_cast<std::uint32_t>( carry );
+            }
+            quotient[j] = static_cast<std::uint32_t>( estimate );
+        }
+
+        // What's left in u is the remainder, still shifted
+        Limbs remainder( n );
+        for( std::size_t i = 0; i < n; ++i )
+            remainder[i] = shift == 0 ? u[i] : ( u[i] >> shift ) | ( u[i + 1] << ( 32 - shift ) );
+        return { BigUint( std::move( quotient ) ), BigUint( std::move( remainder ) ) };
+    }
+
+    auto to_string( BigUint const& value ) -> std::string {
+        if( value.is_zero() )
+            return "0";
+
+        // 10^9, 10^18, 10^36 ... up to about half of value's size
+        std::vector<BigUint> powers = { BigUint( leafDivisor ) };
+        while( powers.back().limbs().size() * 2 <= value.limbs().size() + 1 )
+            powers.push_back( powers.back() * powers.back() );
+
+        std::string text;
+        // log10(2) < 0.30103 - so no more than this, and no reallocating as we go
+        text.reserve( value.bit_width() * 30103 / 100000 + 1 );
+        append_decimal( text, value, 0, powers );
+        return text;
+    }
+
+    auto parse_big_uint( std::string_view sv ) -> std::optional<BigUint> {
+        if( sv.empty() )
+            return {};
+        Limbs limbs;
+        // Nine digits at a time: limbs = limbs * 10^digits + chunk
+        for( std::size_t start = 0; start < sv.size(); ) {
+            std::size_t const digits = start == 0 ? ( sv.size() - 1 ) % leafDigits + 1 : leafDigits;
+            std::uint64_t chunk = 0;
+            for( char c : sv.substr( start, digits ) ) {
+                if( c < '0' || c > '9' )
+                    return {};
+                chunk = chunk * 10 + static_cast<unsigned>( c - '0' );
+            }
+            std::uint64_t carry = chunk;
+            auto const scale = static_cast<std::uint32_t>( detail::powersOf10[digits] );
+            for( auto& limb : limbs ) {
+                std::uint64_t const t = std::uint64_t( limb ) * scale + carry;
+                limb = static_cast<std::uint32_t>( t );
+                carry = t >> 32;
+            }
+            if( carry != 0 )
+                limbs.push_back( static_cast<std::uint32_t>( carry ) );
+            start += digits;
+        }
+        return BigUint( std::move( limbs ) );
+    }
+
+    auto fibonacci( std::uint64_t n ) -> BigUint {
+        // (a, b) = (F(k), F(k+1)), with k built up from n's bits, most significant first
+        BigUint a, b = 1;
+        for( auto bit = detail::bit_width( n ); bit-- > 0; ) {
+            BigUint twiceBMinusA = b + b;
+            twiceBMinusA -= a;
+            BigUint f2k = a * twiceBMinusA;
+            BigUint f2k1 = a * a + b * b;
+            if( ( n >> bit ) & 1 ) {
+                a = f2k1;
+                b = std::move( f2k ) + f2k1;
+            }
+            else {
+                a = std::move( f2k );
+                b = std::move( f2k1 );
+            }
+        }
+        return a;
+    }
+
+    auto fibonacci_sequence( std::size_t count ) -> std::vector<BigUint> {
+        std::vector<BigUint> sequence;
+        sequence.reserve( count );
+        for( std::size_t i = 0; i < count; ++i )
+            sequence.push_back( i < 2 ? BigUint( 1 ) : sequence[i - 1] + sequence[i - 2] );
+        return sequence;
+    }
+}
+
+TEST_CASE( "Big Fibonacci numbers" ) {
+
+    using namespace Cpp17;
+
+    SECTION( "the same start as fib" ) {
+        std::vector<std::string> strings;
+        transform_into( strings, fibonacci_sequence( 6 ), []( BigUint const& f ) { return to_string( f ); } );
+        REQUIRE_THAT( strings, Catch::Matchers::Equals( std::vector<std::string>{ "1", "1", "2", "3", "5", "8" } ) );
+    }
+
+    SECTION( "past 64 bits" ) {
+        REQUIRE( to_string( fibonacci( 0 ) ) == "0" );
+        REQUIRE( to_string( fibonacci( 93 ) ) == "12200160415121876738" ); // the biggest that fits in a uint64_t
+        REQUIRE( to_string( fibonacci( 94 ) ) == "19740274219868223167" );
+        REQUIRE( to_string( fibonacci( 100 ) ) == "354224848179261915075" );
+        REQUIRE( to_string( fibonacci( 300 ) ) == "222232244629420445529739893461909967206666939096499764990979600" );
+    }
+
+    SECTION( "fast doubling agrees with adding" ) {
+        auto sequence = fibonacci_sequence( 3000 );
+        for( std::size_t n : { 1, 2, 3, 10, 93, 94, 95, 500, 1023, 1024, 2999, 3000 } )
+            REQUIRE( fibonacci( n ) == sequence[n - 1] );
+    }
+
+    SECTION( "Cassini: F(n-1) F(n+1) - F(n)^2 = (-1)^n" ) {
+        for( std::uint64_t n : { 10, 11, 1000, 1001, 20000 } ) {
+            auto lhs = fibonacci( n - 1 ) * fibonacci( n + 1 );
+            auto square = fibonacci( n ) * fibonacci( n );
+            REQUIRE( ( n % 2 == 0 ? lhs - square : square - lhs ) == BigUint( 1 ) );
+        }
+    }
+
+    SECTION( "decimal round trip, through the divide and conquer split" ) {
+        for( std::uint64_t n : { 1000, 4321, 20000 } ) {
+            auto f = fibonacci( n );
+            auto text = to_string( f );
+            REQUIRE( text.size() == static_cast<std::size_t>( n * 0.20898764024997873 - 0.3494850021680094 ) + 1 ); // digits of F(n), from log10(phi)
+            REQUIRE( parse_big_uint( text ) == f );
+        }
+        // Runs of zeros either side of the split points
+        auto tenToThe1000 = *parse_big_uint( "1" + std::string( 1000, '0' ) );
+        REQUIRE( to_string( tenToThe1000 ) == "1" + std::string( 1000, '0' ) );
+        REQUIRE( to_string( tenToThe1000 + BigUint( 7 ) ) == "1" + std::string( 999, '0' ) + "7" );
+        REQUIRE( to_string( tenToThe1000 - BigUint( 1 ) ) == std::string( 1000, '9' ) );
+    }
+
+    SECTION( "division" ) {
+        auto a = fibonacci( 5000 ), b = fibonacci( 2000 ) + BigUint( 12345 );
+        auto [quotient, remainder] = divmod( a, b );
+        REQUIRE( remainder < b );
+        REQUIRE( quotient * b + remainder == a );
+        REQUIRE( divmod( b, a ).first.is_zero() );
+
+        REQUIRE_FALSE( parse_big_uint( "" ) );
+        REQUIRE_FALSE( parse_big_uint( "12x" ) );
+    }
+
+    SECTION( "into a packed column" ) {
+        auto sequence = fibonacci_sequence( 500 );
+        StringColumn column;
+        transform_into( column, sequence, []( BigUint const& f ) { return to_string( f ); } );
+        REQUIRE( column.size() == 500 );
+        REQUIRE( column[99] == "354224848179261915075" );
+    }
+}
+
+TEST_CASE( "Big Fibonacci numbers - speed", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    for( std::uint64_t n : { 1000, 10000, 100000 } ) {
+        BENCHMARK( "F(" + std::to_string( n ) + ")" ) {
+            return fibonacci( n );
+        };
+    }
+
+    auto big = fibonacci( 100000 );
+    BENCHMARK( "to_string( F(100000) )" ) {
+        return to_string( big );
+    };
+
+    auto sequence = fibonacci_sequence( 2000 );
+    BENCHMARK( "fibonacci_sequence( 2000 )" ) {
+        return fibonacci_sequence( 2000 );
+    };
+    BENCHMARK( "2000 terms to strings" ) {
+        std::vector<std::string> strings;
+        return transform_into( strings, sequence, []( BigUint const& f ) { return to_string( f ); } ).size();
+    };
+    BENCHMARK( "2000 terms to a StringColumn" ) {
+        StringColumn column;
+        return transform_into( column, sequence, []( BigUint const& f ) { return to_string( f ); } ).size();
+    };
+}
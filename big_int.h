@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Cpp17 {
+
+    // Unsigned integer of any size, as 32 bit limbs (least significant first, never any leading zero limbs,
+    // so zero has none). Just enough arithmetic for Fibonacci numbers and their decimal text
+    class BigUint {
+        std::vector<std::uint32_t> m_limbs;
+
+        void trim() noexcept {
+            while( !m_limbs.empty() && m_limbs.back() == 0 )
+                m_limbs.pop_back();
+        }
+
+    public:
+        BigUint() = default;
+        BigUint( std::uint64_t value ) { // implicit, like the built in types widening
+            for(; value != 0; value >>= 32 )
+                m_limbs.push_back( static_cast<std::uint32_t>( value ) );
+        }
+        explicit BigUint( std::vector<std::uint32_t> limbs ) : m_limbs( std::move( limbs ) ) { trim(); }
+
+        auto limbs() const noexcept -> std::vector<std::uint32_t> const& { return m_limbs; }
+        auto is_zero() const noexcept -> bool { return m_limbs.empty(); }
+        auto bit_width() const noexcept -> std::size_t;
+
+        auto operator+=( BigUint const& other ) -> BigUint&;
+        auto operator-=( BigUint const& other ) -> BigUint&; // other must not be bigger
+        friend auto operator+( BigUint lhs, BigUint const& rhs ) -> BigUint { return lhs += rhs; }
+        friend auto operator-( BigUint lhs, BigUint const& rhs ) -> BigUint { return lhs -= rhs; }
+        friend auto operator*( BigUint const& lhs, BigUint const& rhs ) -> BigUint;
+
+        // Quotient and remainder - divisor must not be zero
+        friend auto divmod( BigUint const& dividend, BigUint const& divisor ) -> std::pair<BigUint, BigUint>;
+
+        friend auto compare( BigUint const& lhs, BigUint const& rhs ) noexcept -> int;
+        friend auto operator==( BigUint const& lhs, BigUint const& rhs ) noexcept -> bool { return lhs.m_limbs == rhs.m_limbs; }
+        friend auto operator!=( BigUint const& lhs, BigUint const& rhs ) noexcept -> bool { return lhs.m_limbs != rhs.m_limbs; }
+        friend auto operator<( BigUint const& lhs, BigUint const& rhs ) noexcept -> bool { return compare( lhs, rhs ) < 0; }
+    };
+
+    // Decimal text. Big values are split in half by a power of ten (10^9, squared as often as needed),
+    // both halves converted the same way, so most of the work is in the many small divisions at the leaves
+    auto to_string( BigUint const& value ) -> std::string;
+
+    // Digits only - nullopt for anything else (including an empty string)
+    auto parse_big_uint( std::string_view sv ) -> std::optional<BigUint>;
+
+    // F(n), with F(0) = 0, F(1) = 1, by fast doubling: F(2k) = F(k)(2F(k+1) - F(k)), F(2k+1) = F(k)^2 + F(k+1)^2
+    // - about log2(n) steps, rather than n additions
+    auto fibonacci( std::uint64_t n ) -> BigUint;
+
+    // F(1) ... F(count), e.g. 1, 1, 2, 3, 5, 8 - each one the sum of the previous two
+    auto fibonacci_sequence( std::size_t count ) -> std::vector<BigUint>;
+}
@@ -0,0 +1,251 @@
+#include "catch.hpp"
+#include "string_conversions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GRANDPARENT_HAS_MMAP
+#endif
+
+namespace Cpp17 {
+
+    namespace {
+
+#ifdef GRANDPARENT_HAS_MMAP
+        [[noreturn]] void throw_errno( std::string const& what ) {
+            throw std::system_error( errno, std::generic_category(), what );
+        }
+
+        // Read-only view of a whole file. The kernel pages it in as we touch it - nothing is copied
+        class MappedFile {
+            void* m_data = nullptr;
+            std::size_t m_size = 0;
+        public:
+            explicit MappedFile( std::string const& path ) {
+                int fd = ::open( path.c_str(), O_RDONLY );
+                if( fd == -1 )
+                    throw_errno( "Unable to open " + path );
+
+                struct stat info;
+                if( ::fstat( fd, &info ) == -1 ) {
+                    int err = errno;
+                    ::close( fd );
+                    errno = err;
+                    throw_errno( "Unable to stat " + path );
+                }
+                m_size = static_cast<std::size_t>( info.st_size );
+
+                if( m_size > 0 ) { // can't map an empty file
+                    m_data = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+                    if( m_data == MAP_FAILED ) {
+                        int err = errno;
+                        ::close( fd );
+                        errno = err;
+                        throw_errno( "Unable to map " + path );
+                    }
+                    ::madvise( m_data, m_size, MADV_SEQUENTIAL );
+                }
+                ::close( fd ); // the mapping keeps the file alive
+            }
+            ~MappedFile() {
+                if( m_data )
+                    ::munmap( m_data, m_size );
+            }
+            MappedFile( MappedFile const& ) = delete;
+            MappedFile& operator=( MappedFile const& ) = delete;
+
+            auto view() const -> std::string_view {
+                return { static_cast<char const*>( m_data ), m_size };
+            }
+        };
+#else
+        // No mmap - fall back to reading the whole file
+        class MappedFile {
+            std::string m_contents;
+        public:
+            explicit MappedFile( std::string const& path ) {
+                std::ifstream file( path, std::ios::binary );
+                if( !file )
+                    throw std::runtime_error( "Unable to open " + path ); // a stream doesn't reliably set errno
+                m_contents.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+            }
+            auto view() const -> std::string_view { return m_contents; }
+        };
+#endif
+
+        // Split roughly evenly, then push each boundary to just after the next delimiter,
+        // so every chunk holds whole tokens (some chunks may end up empty)
+        auto split_on_delimiters( std::string_view contents, char delimiter, unsigned chunks ) -> std::vector<std::string_view> {
+            std::vector<std::string_view> result;
+            result.reserve( chunks );
+            std::size_t start = 0;
+            for( unsigned i = 1; i <= chunks; ++i ) {
+                std::size_t end = contents.size();
+                if( i < chunks ) {
+                    end = std::max( start, contents.size() / chunks * i );
+                    auto delim = contents.find( delimiter, end );
+                    end = delim == std::string_view::npos ? contents.size() : delim + 1;
+                }
+                result.push_back( contents.substr( start, end - start ) );
+                start = end;
+            }
+            return result;
+        }
+    }
+
+    auto parse_ints_from_file( std::string const& path, char delimiter, unsigned threads ) -> ParsedInts {
+        if( threads == 0 )
+            threads = std::max( 1u, std::thread::hardware_concurrency() );
+
+        MappedFile file( path );
+        // Not worth a thread for less than this
+        constexpr std::size_t minChunkBytes = 4096;
+        threads = static_cast<unsigned>( std::min<std::size_t>( threads, std::max<std::size_t>( 1, file.view().size() / minChunkBytes ) ) );
+        auto chunks = split_on_delimiters( file.view(), delimiter, threads );
+
+        std::vector<ParsedInts> results( chunks.size() );
+        {
+            std::vector<std::thread> workers;
+            workers.reserve( chunks.size() - 1 );
+            auto joinAll = [&workers] {
+                for( auto& worker : workers )
+                    worker.join();
+            };
+            try {
+                for( std::size_t i = 1; i < chunks.size(); ++i )
+                    workers.emplace_back( [&, i] { parse_ints( chunks[i], delimiter, results[i] ); } );
+                parse_ints( chunks[0], delimiter, results[0] ); // this thread takes the first chunk
+            }
+            catch( ... ) {
+                joinAll(); // destroying a joinable thread would terminate - and they're still using results
+                throw;
+            }
+            joinAll();
+        }
+        if( results.size() == 1 )
+            return std::move( results[0] );
+
+        // Stitch back together in input order - indices and offsets were relative to each chunk
+        std::size_t totalValues = 0, totalFailures = 0;
+        for( auto const& result : results ) {
+            totalValues += result.values.size();
+            totalFailures += result.failures.size();
+        }
+        ParsedInts merged;
+        merged.values.reserve( totalValues );
+        merged.failures.reserve( totalFailures );
+        for( std::size_t i = 0; i < results.size(); ++i ) {
+            auto indexBase = merged.values.size();
+            auto offsetBase = static_cast<std::size_t>( chunks[i].data() - chunks[0].data() );
+            merged.values.insert( merged.values.end(), results[i].values.begin(), results[i].values.end() );
+            for( auto failure : results[i].failures ) {
+                failure.index += indexBase;
+                failure.offset += offsetBase;
+                merged.failures.push_back( failure );
+            }
+        }
+        return merged;
+    }
+}
+
+namespace {
+
+    // A file in the temp directory, named so that no other test run (or other file here) uses the same one,
+    // and removed again when done
+    class TempFile {
+        std::string m_path;
+
+        static auto unique_path() -> std::string {
+            static std::atomic<unsigned> counter{ 0 };
+#ifdef GRANDPARENT_HAS_MMAP
+            auto const process = static_cast<unsigned long>( ::getpid() );
+#else
+            auto const process = static_cast<unsigned long>( std::random_device()() );
+#endif
+            auto name = "grandparent_parse_ints_" + std::to_string( process ) + "_" + std::to_string( ++counter ) + ".txt";
+            return ( std::filesystem::temp_directory_path() / name ).string();
+        }
+
+    public:
+        explicit TempFile( std::string const& contents ) : m_path( unique_path() ) {
+            std::ofstream file( m_path, std::ios::binary );
+            file << contents;
+        }
+        TempFile( TempFile const& ) = delete;
+        auto operator=( TempFile const& ) -> TempFile& = delete;
+        ~TempFile() { std::remove( m_path.c_str() ); }
+
+        auto path() const -> std::string const& { return m_path; }
+    };
+}
+
+TEST_CASE( "Parse ints from file" ) {
+
+    using namespace Cpp17;
+
+    // Written once, however many sections run
+    static std::string const contents = [] {
+        std::string contents;
+        for( int i = 0; i < 10000; ++i ) {
+            if( i % 997 == 0 )
+                contents += "Blakes7";
+            else
+                contents += std::to_string( i % 2 == 0 ? i : -i * 1000 );
+            contents += '\n';
+        }
+        contents += "42"; // no trailing newline
+        return contents;
+    }();
+    static TempFile const numbers( contents );
+
+    SECTION( "same results as parsing it in memory" ) {
+        ParsedInts expected;
+        parse_ints( contents, '\n', expected );
+
+        for( unsigned threads : { 1u, 2u, 3u, 8u, 64u, 0u } ) {
+            auto result = parse_ints_from_file( numbers.path(), '\n', threads );
+            REQUIRE( result.values == expected.values );
+            REQUIRE( result.failures.size() == expected.failures.size() );
+            for( std::size_t i = 0; i < result.failures.size(); ++i ) {
+                REQUIRE( result.failures[i].index == expected.failures[i].index );
+                REQUIRE( result.failures[i].offset == expected.failures[i].offset );
+            }
+        }
+        REQUIRE( expected.values.back() == 42 );
+        REQUIRE( expected.failures.size() == 11 );
+    }
+
+    SECTION( "empty file" ) {
+        TempFile empty( "" );
+        REQUIRE( parse_ints_from_file( empty.path(), '\n', 4 ).values.empty() );
+    }
+
+    SECTION( "small file, many threads" ) {
+        TempFile small( "1\n2\nx\n3" );
+        auto result = parse_ints_from_file( small.path(), '\n', 64 );
+        REQUIRE( result.values == std::vector<int>{ 1, 2, 0, 3 } );
+        REQUIRE( result.failures.size() == 1 );
+        REQUIRE( result.failures[0].offset == 4 );
+    }
+
+    SECTION( "missing file" ) {
+        REQUIRE_THROWS_AS( parse_ints_from_file( numbers.path() + ".missing" ), std::runtime_error );
+#ifdef GRANDPARENT_HAS_MMAP
+        REQUIRE_THROWS_AS( parse_ints_from_file( numbers.path() + ".missing" ), std::system_error );
+#endif
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "int_to_string.h"
+#include "string_conversions.h"
+
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace Cpp17 {
+
+    // A stand-in for std::stringstream when all we want is to build some text with <<.
+    // No stream, no locale: numbers go through write_decimal and format_double, straight into a buffer
+    // that starts inline and only goes to the heap (doubling) if the text outgrows it.
+    // clear() just forgets the text - the buffer, and any heap it has grown into, is kept for next time
+    class Formatter {
+        static constexpr std::size_t inlineCapacity = 128;
+
+        char m_inline[inlineCapacity];
+        std::unique_ptr<char[]> m_heap;
+        char* m_data = m_inline;
+        std::size_t m_size = 0;
+        std::size_t m_capacity = inlineCapacity;
+
+        // Room for at least count more chars, returning where they go
+        auto grow( std::size_t count ) -> char* {
+            if( m_size + count > m_capacity ) {
+                std::size_t capacity = m_capacity * 2;
+                while( capacity < m_size + count )
+                    capacity *= 2;
+                auto heap = std::make_unique<char[]>( capacity );
+                std::memcpy( heap.get(), m_data, m_size );
+                m_heap = std::move( heap );
+                m_data = m_heap.get();
+                m_capacity = capacity;
+            }
+            return m_data + m_size;
+        }
+
+        // Anything std::to_chars takes
+        template<typename T, typename... Format>
+        auto write_chars( T value, Format... format ) -> Formatter& {
+            constexpr std::size_t maxChars = 64;
+            // Floats are only written shortest round trip: sign, digits, point, 'e', exponent sign and up to
+            // four exponent digits. Integers: a digit per bit (in base 2), plus a sign
+            if constexpr( std::is_floating_point_v<T> )
+                static_assert( sizeof...( Format ) == 0 && std::numeric_limits<T>::max_digits10 + 8 <= maxChars );
+            else
+                static_assert( std::numeric_limits<T>::digits + std::numeric_limits<T>::is_signed <= maxChars );
+
+            char* out = grow( maxChars );
+            auto const result = std::to_chars( out, out + maxChars, value, format... );
+            assert( result.ec == std::errc() );
+            m_size = static_cast<std::size_t>( result.ptr - m_data );
+            return *this;
+        }
+
+    public:
+        Formatter() = default;
+        Formatter( Formatter const& ) = delete;
+        auto operator=( Formatter const& ) -> Formatter& = delete;
+
+        void clear() noexcept { m_size = 0; }
+
+        auto size() const noexcept -> std::size_t { return m_size; }
+        auto capacity() const noexcept -> std::size_t { return m_capacity; }
+        auto view() const noexcept -> std::string_view { return { m_data, m_size }; }
+        auto str() const -> std::string { return std::string( view() ); }
+
+        auto operator<<( std::string_view text ) -> Formatter& {
+            std::memcpy( grow( text.size() ), text.data(), text.size() );
+            m_size += text.size();
+            return *this;
+        }
+        auto operator<<( char const* text ) -> Formatter& { return *this << std::string_view( text ); }
+        auto operator<<( std::string const& text ) -> Formatter& { return *this << std::string_view( text ); }
+        auto operator<<( char c ) -> Formatter& {
+            *grow( 1 ) = c;
+            ++m_size;
+            return *this;
+        }
+        // As an ostream does, int8_t and uint8_t are chars too
+        auto operator<<( signed char c ) -> Formatter& { return *this << static_cast<char>( c ); }
+        auto operator<<( unsigned char c ) -> Formatter& { return *this << static_cast<char>( c ); }
+        // As an ostream without std::boolalpha would
+        auto operator<<( bool value ) -> Formatter& { return *this << ( value ? '1' : '0' ); }
+
+        template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof( T ) != 1>>
+        auto operator<<( T value ) -> Formatter& {
+            m_size = static_cast<std::size_t>( write_decimal( grow( maxDecimalLength<T> ), value ) - m_data );
+            return *this;
+        }
+
+        // Shortest text that reads back as the same value - not ostream's default 6 significant digits
+        auto operator<<( double value ) -> Formatter& {
+            char* out = grow( maxDoubleChars );
+            m_size = static_cast<std::size_t>( format_double( value, out, out + maxDoubleChars ) - m_data );
+            return *this;
+        }
+        auto operator<<( float value ) -> Formatter& { return write_chars( value ); }
+        auto operator<<( long double value ) -> Formatter& { return write_chars( value ); }
+
+        // Other pointers as addresses, e.g. 0x7ffd5a3c (0 if null), as libstdc++'s ostream does -
+        // except char pointers, which are strings, and function pointers, which (like ostream) are bools
+        template<typename T>
+        auto operator<<( T* pointer ) -> Formatter& {
+            if constexpr( std::is_same_v<std::remove_cv_t<T>, char> || std::is_same_v<std::remove_cv_t<T>, signed char> || std::is_same_v<std::remove_cv_t<T>, unsigned char> )
+                return *this << std::string_view( reinterpret_cast<char const*>( pointer ) );
+            else if constexpr( std::is_function_v<T> )
+                return *this << ( pointer != nullptr );
+            else if( !pointer )
+                return *this << '0';
+            else {
+                *this << "0x";
+                return write_chars( reinterpret_cast<std::uintptr_t>( pointer ), 16 );
+            }
+        }
+    };
+
+    // This thread's Formatter, already cleared - for code that made a stringstream each time round a loop, e.g.
+    //     auto& ss = local_formatter();
+    //     ss << *it;
+    //     strings.push_back( ss.str() );
+    // The reference is only good until the next call on the same thread
+    inline auto local_formatter() -> Formatter& {
+        thread_local Formatter formatter;
+        formatter.clear();
+        return formatter;
+    }
+}
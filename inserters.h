@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace Cpp17 {
+
+    // std::back_inserter can't know how many elements are coming, so the container grows as they arrive,
+    // moving what's already there each time. These know - if the input range does - and reserve once, up front
+
+    namespace detail {
+        template<typename Container, typename = void>
+        inline constexpr bool has_reserve = false;
+        template<typename Container>
+        inline constexpr bool has_reserve<Container, std::void_t<
+                decltype( std::declval<Container&>().reserve( std::size_t() ) ),
+                decltype( std::declval<Container const&>().capacity() )>> = true;
+
+        template<typename Range, typename = void>
+        inline constexpr bool has_size = false;
+        template<typename Range>
+        inline constexpr bool has_size<Range, std::void_t<decltype( std::size( std::declval<Range const&>() ) )>> = true;
+
+        template<typename Range>
+        using iterator_category_of = typename std::iterator_traits<decltype( std::begin( std::declval<Range const&>() ) )>::iterator_category;
+    }
+
+    // Room for count more elements. If that needs a bigger buffer it's at least double the old one,
+    // so filling a container a bit at a time (e.g. transform_into, over and over) still grows it geometrically.
+    // Containers without reserve (e.g. std::deque, which never moves its elements) are left as they are
+    template<typename Container>
+    void reserve_more( Container& container, std::size_t count ) {
+        if constexpr( detail::has_reserve<Container> ) {
+            std::size_t const needed = container.size() + count;
+            if( needed > container.capacity() )
+                container.reserve( std::max<std::size_t>( needed, container.capacity() * 2 ) );
+        }
+    }
+
+    // Elements in input, if that can be known without consuming it - or 0 for a single pass (input iterator) range
+    template<typename Range>
+    auto size_if_known( Range const& input ) -> std::size_t {
+        if constexpr( detail::has_size<Range> )
+            return static_cast<std::size_t>( std::size( input ) );
+        else if constexpr( std::is_base_of_v<std::forward_iterator_tag, detail::iterator_category_of<Range>> )
+            return static_cast<std::size_t>( std::distance( std::begin( input ), std::end( input ) ) );
+        else
+            return 0;
+    }
+
+    // e.g. std::copy( first, last, sized_back_inserter( strings, count ) )
+    template<typename Container>
+    auto sized_back_inserter( Container& container, std::size_t count ) -> std::back_insert_iterator<Container> {
+        reserve_more( container, count );
+        return std::back_inserter( container );
+    }
+
+    // e.g. std::transform( fib.begin(), fib.end(), sized_back_inserter( strings, fib ), convert )
+    template<typename Container, typename Range>
+    auto sized_back_inserter( Container& container, Range const& input ) -> std::back_insert_iterator<Container> {
+        return sized_back_inserter( container, size_if_known( input ) );
+    }
+
+    // Appends fn( x ) for every x in input - reserving first, when it can
+    template<typename Container, typename Range, typename Fn>
+    auto transform_into( Container& container, Range const& input, Fn fn ) -> Container& {
+        std::transform( std::begin( input ), std::end( input ), sized_back_inserter( container, input ), std::move( fn ) );
+        return container;
+    }
+}
@@ -0,0 +1,313 @@
+#include "catch.hpp"
+#include "int_to_string.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <immintrin.h>
+#define GRANDPARENT_X86_SIMD
+#endif
+
+namespace Cpp17 {
+
+    namespace {
+
+        template<typename T>
+        auto write_decimals_scalar( T const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset ) -> char* {
+            char* const start = out;
+            for( std::size_t i = 0; i < count; ++i ) {
+                out = write_decimal( out, values[i] );
+                if( ends )
+                    ends[i] = offset + static_cast<std::size_t>( out - start );
+            }
+            return out;
+        }
+
+#ifdef GRANDPARENT_X86_SIMD
+        // The kernels give the last eight digits of eight values (the magnitude % 10^8), zero padded,
+        // eight chars each, in order. Anything above that is at most two more digits, done as we copy them out.
+        //
+        // x / 10^8 and x / 10^4 are a multiply then a shift, by 2^58 / 10^8 and 2^45 / 10^4 rounded up
+        // - exact for every 32 bit x. The eight digits are then two groups of four, abcd and efgh.
+        // A group, times 4, broadcast to four 16 bit lanes, becomes a, ab, abc, abcd by multiplying by 2^n / 10^k
+        // and keeping the high half (twice - the second one is a per-lane shift).
+        // Subtracting ten times each lane from the next leaves a, b, c, d
+        constexpr int div1e8Shift = 58, div1e4Shift = 45;
+        constexpr int div1e8Multiplier = static_cast<int>( 0xABCC7712 ), div1e4Multiplier = static_cast<int>( 0xD1B71759 );
+        constexpr short highBit = static_cast<short>( 0x8000 );
+
+        template<int Shift>
+        __attribute__(( target( "sse2" ) ))
+        auto divide_sse2( __m128i values, __m128i multiplier ) -> __m128i {
+            // _mm_mul_epu32 only multiplies the even lanes, so the odd ones are moved down and done separately
+            __m128i const even = _mm_srli_epi64( _mm_mul_epu32( values, multiplier ), Shift );
+            __m128i const odd = _mm_srli_epi64( _mm_mul_epu32( _mm_srli_epi64( values, 32 ), multiplier ), Shift );
+            return _mm_or_si128( even, _mm_slli_epi64( odd, 32 ) );
+        }
+        // Only for products that fit in 32 bits - SSE2 has no _mm_mullo_epi32
+        __attribute__(( target( "sse2" ) ))
+        auto multiply_sse2( __m128i values, __m128i multiplier ) -> __m128i {
+            __m128i const even = _mm_mul_epu32( values, multiplier );
+            __m128i const odd = _mm_mul_epu32( _mm_srli_epi64( values, 32 ), multiplier );
+            return _mm_or_si128( even, _mm_slli_epi64( odd, 32 ) );
+        }
+        __attribute__(( target( "sse2" ) ))
+        auto digits_sse2( __m128i groups ) -> __m128i {
+            __m128i const prefixes = _mm_mulhi_epu16(
+                _mm_mulhi_epu16( groups, _mm_setr_epi16( 8389, 5243, 13108, highBit, 8389, 5243, 13108, highBit ) ),
+                _mm_setr_epi16( 1 << 7, 1 << 11, 1 << 13, highBit, 1 << 7, 1 << 11, 1 << 13, highBit ) );
+            return _mm_sub_epi16( prefixes, _mm_slli_epi64( _mm_mullo_epi16( prefixes, _mm_set1_epi16( 10 ) ), 16 ) );
+        }
+
+        // Four values per call, so twice for eight
+        template<typename T>
+        __attribute__(( target( "sse2" ) ))
+        void four_values_sse2( T const* values, char* digits ) {
+            __m128i magnitudes = _mm_loadu_si128( reinterpret_cast<__m128i const*>( values ) );
+            if constexpr( std::is_signed_v<T> ) {
+                __m128i const sign = _mm_srai_epi32( magnitudes, 31 );
+                magnitudes = _mm_sub_epi32( _mm_xor_si128( magnitudes, sign ), sign );
+            }
+            __m128i const high = divide_sse2<div1e8Shift>( magnitudes, _mm_set1_epi32( div1e8Multiplier ) );
+            __m128i const low = _mm_sub_epi32( magnitudes, multiply_sse2( high, _mm_set1_epi32( 100000000 ) ) );
+            __m128i const abcd = divide_sse2<div1e4Shift>( low, _mm_set1_epi32( div1e4Multiplier ) );
+            __m128i const efgh = _mm_sub_epi32( low, multiply_sse2( abcd, _mm_set1_epi32( 10000 ) ) );
+
+            // 16 bit lanes of abcd0, efgh0, abcd1, efgh1..., then each value's groups spread over 64 bits each
+            __m128i const groups = _mm_slli_epi16( _mm_or_si128( abcd, _mm_slli_epi32( efgh, 16 ) ), 2 );
+            __m128i const pairs01 = _mm_unpacklo_epi16( groups, groups );
+            __m128i const pairs23 = _mm_unpackhi_epi16( groups, groups );
+            __m128i const digits01 = _mm_packus_epi16(
+                digits_sse2( _mm_unpacklo_epi32( pairs01, pairs01 ) ),
+                digits_sse2( _mm_unpackhi_epi32( pairs01, pairs01 ) ) );
+            __m128i const digits23 = _mm_packus_epi16(
+                digits_sse2( _mm_unpacklo_epi32( pairs23, pairs23 ) ),
+                digits_sse2( _mm_unpackhi_epi32( pairs23, pairs23 ) ) );
+            __m128i const zero = _mm_set1_epi8( '0' );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( digits ), _mm_add_epi8( digits01, zero ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( digits + 16 ), _mm_add_epi8( digits23, zero ) );
+        }
+        template<typename T>
+        __attribute__(( target( "sse2" ) ))
+        void eight_values_sse2( T const* values, char* digits ) {
+            four_values_sse2( values, digits );
+            four_values_sse2( values + 4, digits + 32 );
+        }
+
+        // The same steps, a whole 256 bits at a time. The unpacks and packs work within each 128 bit half,
+        // so values 0-3 end up in the low halves and 4-7 in the high ones, until the final permutes
+        template<int Shift>
+        __attribute__(( target( "avx2" ) ))
+        auto divide_avx2( __m256i values, __m256i multiplier ) -> __m256i {
+            __m256i const even = _mm256_srli_epi64( _mm256_mul_epu32( values, multiplier ), Shift );
+            __m256i const odd = _mm256_srli_epi64( _mm256_mul_epu32( _mm256_srli_epi64( values, 32 ), multiplier ), Shift );
+            return _mm256_or_si256( even, _mm256_slli_epi64( odd, 32 ) );
+        }
+        __attribute__(( target( "avx2" ) ))
+        auto digits_avx2( __m256i groups ) -> __m256i {
+            __m256i const prefixes = _mm256_mulhi_epu16(
+                _mm256_mulhi_epu16( groups, _mm256_setr_epi16(
+                    8389, 5243, 13108, highBit, 8389, 5243, 13108, highBit,
+                    8389, 5243, 13108, highBit, 8389, 5243, 13108, highBit ) ),
+                _mm256_setr_epi16(
+                    1 << 7, 1 << 11, 1 << 13, highBit, 1 << 7, 1 << 11, 1 << 13, highBit,
+                    1 << 7, 1 << 11, 1 << 13, highBit, 1 << 7, 1 << 11, 1 << 13, highBit ) );
+            return _mm256_sub_epi16( prefixes, _mm256_slli_epi64( _mm256_mullo_epi16( prefixes, _mm256_set1_epi16( 10 ) ), 16 ) );
+        }
+
+        template<typename T>
+        __attribute__(( target( "avx2" ) ))
+        void eight_values_avx2( T const* values, char* digits ) {
+            __m256i magnitudes = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( values ) );
+            if constexpr( std::is_signed_v<T> )
+                magnitudes = _mm256_abs_epi32( magnitudes ); // INT_MIN stays 0x80000000 - right, as unsigned
+            __m256i const high = divide_avx2<div1e8Shift>( magnitudes, _mm256_set1_epi32( div1e8Multiplier ) );
+            __m256i const low = _mm256_sub_epi32( magnitudes, _mm256_mullo_epi32( high, _mm256_set1_epi32( 100000000 ) ) );
+            __m256i const abcd = divide_avx2<div1e4Shift>( low, _mm256_set1_epi32( div1e4Multiplier ) );
+            __m256i const efgh = _mm256_sub_epi32( low, _mm256_mullo_epi32( abcd, _mm256_set1_epi32( 10000 ) ) );
+
+            __m256i const groups = _mm256_slli_epi16( _mm256_or_si256( abcd, _mm256_slli_epi32( efgh, 16 ) ), 2 );
+            __m256i const pairs0145 = _mm256_unpacklo_epi16( groups, groups );
+            __m256i const pairs2367 = _mm256_unpackhi_epi16( groups, groups );
+            __m256i const digits0145 = _mm256_packus_epi16(
+                digits_avx2( _mm256_unpacklo_epi32( pairs0145, pairs0145 ) ),
+                digits_avx2( _mm256_unpackhi_epi32( pairs0145, pairs0145 ) ) );
+            __m256i const digits2367 = _mm256_packus_epi16(
+                digits_avx2( _mm256_unpacklo_epi32( pairs2367, pairs2367 ) ),
+                digits_avx2( _mm256_unpackhi_epi32( pairs2367, pairs2367 ) ) );
+            __m256i const zero = _mm256_set1_epi8( '0' );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( digits ),
+                _mm256_add_epi8( _mm256_permute2x128_si256( digits0145, digits2367, 0x20 ), zero ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( digits + 32 ),
+                _mm256_add_epi8( _mm256_permute2x128_si256( digits0145, digits2367, 0x31 ), zero ) );
+        }
+
+        // Copies out just the digits each value needs (plus any '-', and the one or two digits above 10^8)
+        template<typename T, void( *EightValues )( T const*, char* )>
+        auto write_decimals_simd( T const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset ) -> char* {
+            char* const start = out;
+            char digits[64];
+            std::size_t i = 0;
+            for(; count - i >= 8; i += 8 ) {
+                EightValues( values + i, digits );
+                for( std::size_t j = 0; j < 8; ++j ) {
+                    T const value = values[i + j];
+                    auto const magnitude = static_cast<std::uint32_t>( detail::magnitude( value ) );
+                    if constexpr( std::is_signed_v<T> ) {
+                        if( value < 0 )
+                            *out++ = '-';
+                    }
+                    unsigned const length = decimal_digits( magnitude );
+                    if( length > 8 ) {
+                        auto const high = magnitude / 100000000;
+                        if( high >= 10 ) {
+                            *out++ = detail::digitPairs[high * 2];
+                            *out++ = detail::digitPairs[high * 2 + 1];
+                        }
+                        else {
+                            *out++ = static_cast<char>( '0' + high );
+                        }
+                        std::memcpy( out, digits + j * 8, 8 );
+                        out += 8;
+                    }
+                    else {
+                        std::memcpy( out, digits + j * 8 + 8 - length, length );
+                        out += length;
+                    }
+                    if( ends )
+                        ends[i + j] = offset + static_cast<std::size_t>( out - start );
+                }
+            }
+            return write_decimals_scalar( values + i, count - i, out, ends ? ends + i : nullptr, offset + static_cast<std::size_t>( out - start ) );
+        }
+#endif
+
+        template<typename T>
+        auto write_decimals_at( T const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset, SimdLevel level ) -> char* {
+            if( level > detected_simd_level() )
+                level = detected_simd_level();
+            switch( level ) {
+#ifdef GRANDPARENT_X86_SIMD
+                case SimdLevel::AVX2:
+                    return write_decimals_simd<T, eight_values_avx2<T>>( values, count, out, ends, offset );
+                case SimdLevel::SSE2:
+                    return write_decimals_simd<T, eight_values_sse2<T>>( values, count, out, ends, offset );
+#endif
+                default:
+                    return write_decimals_scalar( values, count, out, ends, offset );
+            }
+        }
+    }
+
+    auto write_decimals( std::int32_t const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset ) -> char* {
+        return write_decimals_at( values, count, out, ends, offset, detected_simd_level() );
+    }
+    auto write_decimals( std::uint32_t const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset ) -> char* {
+        return write_decimals_at( values, count, out, ends, offset, detected_simd_level() );
+    }
+    auto write_decimals( std::int32_t const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset, SimdLevel level ) -> char* {
+        return write_decimals_at( values, count, out, ends, offset, level );
+    }
+    auto write_decimals( std::uint32_t const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset, SimdLevel level ) -> char* {
+        return write_decimals_at( values, count, out, ends, offset, level );
+    }
+}
+
+TEST_CASE( "Integer to decimal with SIMD" ) {
+
+    using namespace Cpp17;
+
+    // Every level, and every count up to a few blocks - so each value is checked in every lane, and in the tail
+    auto check = []( auto const& values ) {
+        std::string expected;
+        for( auto value : values )
+            expected += std::to_string( value );
+
+        for( auto level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 } ) {
+            for( std::size_t count = 0; count <= values.size(); ++count ) {
+                std::string text( total_decimal_length( values.begin(), values.begin() + count ), '\0' );
+                std::vector<std::size_t> ends( count );
+                char* end = write_decimals( values.data(), count, text.data(), ends.data(), 3, level );
+
+                REQUIRE( end == text.data() + text.size() );
+                REQUIRE( text == expected.substr( 0, text.size() ) );
+                std::size_t offset = 3;
+                for( std::size_t i = 0; i < count; ++i ) {
+                    offset += decimal_length( values[i] );
+                    REQUIRE( ends[i] == offset );
+                }
+            }
+        }
+    };
+
+    SECTION( "edge values" ) {
+        std::vector<std::uint32_t> unsignedValues = { 0, 1, 9, 10, 99, 100, 42949672, 429496729, 4294967295u, 4294967294u, 2147483648u };
+        std::vector<std::int32_t> signedValues = { 0, -1, 1, std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max(), -2147483647 };
+
+        // Either side of every power of ten, and of 10^8 and 10^4 multiples (where the kernels split values)
+        for( std::uint64_t p = 1; p <= 1000000000; p *= 10 ) {
+            for( std::uint64_t edge : { p, p * 2, p * 4, p * 9, p * 10 - 1 } ) {
+                for( std::uint64_t value : { edge - 1, edge, edge + 1 } ) {
+                    if( value > std::numeric_limits<std::uint32_t>::max() )
+                        continue;
+                    unsignedValues.push_back( static_cast<std::uint32_t>( value ) );
+                    if( value <= static_cast<std::uint64_t>( std::numeric_limits<std::int32_t>::max() ) ) {
+                        signedValues.push_back( static_cast<std::int32_t>( value ) );
+                        signedValues.push_back( -static_cast<std::int32_t>( value ) );
+                    }
+                }
+            }
+        }
+        check( unsignedValues );
+        check( signedValues );
+    }
+
+    SECTION( "random values" ) {
+        std::mt19937 rng( 11 );
+        std::vector<std::uint32_t> unsignedValues;
+        std::vector<std::int32_t> signedValues;
+        for( int i = 0; i < 40; ++i ) {
+            auto bits = rng();
+            unsignedValues.push_back( bits >> ( bits % 32 ) );
+            signedValues.push_back( static_cast<std::int32_t>( bits ) >> ( bits % 32 ) );
+        }
+        check( unsignedValues );
+        check( signedValues );
+    }
+
+    SECTION( "every kernel matches the scalar conversion" ) {
+        std::vector<std::uint32_t> values( 100000 );
+        std::mt19937 rng( 12 );
+        for( auto& value : values )
+            value = rng() >> ( rng() % 32 );
+        std::string expected( total_decimal_length( values.begin(), values.end() ), '\0' );
+        write_decimals( values.data(), values.size(), expected.data(), nullptr, 0, SimdLevel::Scalar );
+        for( auto level : { SimdLevel::SSE2, SimdLevel::AVX2 } ) {
+            std::string text( expected.size(), '\0' );
+            write_decimals( values.data(), values.size(), text.data(), nullptr, 0, level );
+            REQUIRE( text == expected );
+        }
+    }
+}
+
+TEST_CASE( "Integer to decimal with SIMD - every uint32", "[.][exhaustive]" ) {
+
+    // All 2^32 values through the detected kernel - takes a while, so only when asked for, e.g. GrandParent "[exhaustive]"
+    using namespace Cpp17;
+
+    std::vector<std::uint32_t> values( 1 << 16 );
+    std::vector<char> expected( values.size() * 10 ), text( values.size() * 10 );
+    for( std::uint64_t first = 0; first <= std::numeric_limits<std::uint32_t>::max(); first += values.size() ) {
+        for( std::size_t i = 0; i < values.size(); ++i )
+            values[i] = static_cast<std::uint32_t>( first + i );
+        auto expectedEnd = write_decimals( values.data(), values.size(), expected.data(), nullptr, 0, SimdLevel::Scalar );
+        auto end = write_decimals( values.data(), values.size(), text.data() );
+        if( end - text.data() != expectedEnd - expected.data() || !std::equal( text.data(), end, expected.data() ) )
+            FAIL( "Wrong conversion in the block starting at " << first );
+    }
+}
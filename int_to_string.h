@@ -0,0 +1,247 @@
+#pragma once
+
+#include "simd_level.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Cpp17 {
+
+    namespace detail {
+        // "00" "01" ... "99" - two digits per lookup, so half the divisions
+        inline constexpr char digitPairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        inline constexpr std::uint64_t powersOf10[] = {
+            1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+            1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+            100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+            1000000000000000000ull, 10000000000000000000ull };
+
+        constexpr auto bit_width( std::uint64_t value ) -> unsigned {
+#if defined( __GNUC__ ) || defined( __clang__ )
+            return value == 0 ? 0 : 64 - static_cast<unsigned>( __builtin_clzll( value ) );
+#else
+            unsigned width = 0;
+            for(; value != 0; value >>= 1 )
+                ++width;
+            return width;
+#endif
+        }
+
+        template<typename T>
+        constexpr auto magnitude( T value ) -> std::make_unsigned_t<T> {
+            using U = std::make_unsigned_t<T>;
+            if constexpr( std::is_signed_v<T> )
+                return value < 0 ? static_cast<U>( U( 0 ) - static_cast<U>( value ) ) : static_cast<U>( value );
+            else
+                return value;
+        }
+
+        // Contiguous ranges of 32 bit ints can go to write_decimals, below
+        template<typename Range>
+        using element_of = std::remove_cv_t<std::remove_pointer_t<decltype( std::data( std::declval<Range const&>() ) )>>;
+
+        template<typename Range, typename = void>
+        inline constexpr bool has_decimal_kernel = false;
+        template<typename Range>
+        inline constexpr bool has_decimal_kernel<Range, std::void_t<element_of<Range>>> =
+            std::is_same_v<element_of<Range>, std::int32_t> || std::is_same_v<element_of<Range>, std::uint32_t>;
+    }
+
+    // Number of decimal digits, without a loop: log2 from the highest set bit, scaled by log10(2) ~ 1233/4096,
+    // then one comparison to correct it
+    // (value | 1 so that 0 counts as one digit - it never crosses a power of ten)
+    constexpr auto decimal_digits( std::uint64_t value ) -> unsigned {
+        value |= 1;
+        unsigned const guess = ( detail::bit_width( value ) * 1233 ) >> 12;
+        return guess + ( value >= detail::powersOf10[guess] ? 1 : 0 );
+    }
+
+    // Characters needed for value, including any '-'
+    template<typename T>
+    constexpr auto decimal_length( T value ) -> std::size_t {
+        static_assert( std::is_integral_v<T>, "decimal_length needs an integer type" );
+        bool const negative = std::is_signed_v<T> && value < 0;
+        return decimal_digits( detail::magnitude( value ) ) + ( negative ? 1 : 0 );
+    }
+
+    // Writes exactly decimal_length( value ) chars at out (no terminator) and returns the end
+    template<typename T>
+    constexpr auto write_decimal( char* out, T value ) -> char* {
+        static_assert( std::is_integral_v<T>, "write_decimal needs an integer type" );
+        auto v = static_cast<std::uint64_t>( detail::magnitude( value ) );
+        if constexpr( std::is_signed_v<T> ) {
+            if( value < 0 )
+                *out++ = '-';
+        }
+        char* const end = out + decimal_digits( v );
+        char* p = end;
+        while( v >= 100 ) {
+            auto const pair = ( v % 100 ) * 2;
+            v /= 100;
+            *--p = detail::digitPairs[pair + 1];
+            *--p = detail::digitPairs[pair];
+        }
+        if( v >= 10 ) {
+            *--p = detail::digitPairs[v * 2 + 1];
+            *--p = detail::digitPairs[v * 2];
+        }
+        else {
+            *--p = static_cast<char>( '0' + v );
+        }
+        return end;
+    }
+
+    // Longest text for any value of T, e.g. 20 for std::int64_t ("-9223372036854775808")
+    template<typename T>
+    inline constexpr std::size_t maxDecimalLength = std::numeric_limits<T>::digits10 + 1 + ( std::is_signed_v<T> ? 1 : 0 );
+
+    // Text of a number stored inline, in a fixed Capacity chars - so it never touches the heap
+    // (std::string only avoids it up to its SSO limit, which 64 bit values, or anything prefixed, soon pass).
+    // It's trivially copyable, so vectors of them are plain memory, and it converts to std::string_view
+    template<std::size_t Capacity>
+    class DecimalString {
+        static_assert( Capacity <= 255, "DecimalString keeps its size in one byte" );
+        char m_chars[Capacity] = {};
+        unsigned char m_size = 0;
+
+    public:
+        static constexpr std::size_t capacity = Capacity;
+
+        constexpr DecimalString() = default;
+
+        // Prefix, then value - throws std::length_error if they don't fit
+        template<typename T>
+        constexpr DecimalString( std::string_view prefix, T value ) {
+            std::size_t const size = prefix.size() + decimal_length( value );
+            if( size > Capacity )
+                throw std::length_error( "Value doesn't fit in DecimalString" );
+            for( std::size_t i = 0; i < prefix.size(); ++i )
+                m_chars[i] = prefix[i];
+            write_decimal( m_chars + prefix.size(), value );
+            m_size = static_cast<unsigned char>( size );
+        }
+
+        constexpr auto size() const noexcept -> std::size_t { return m_size; }
+        constexpr auto empty() const noexcept -> bool { return m_size == 0; }
+        constexpr auto data() const noexcept -> char const* { return m_chars; }
+        constexpr auto begin() const noexcept -> char const* { return m_chars; }
+        constexpr auto end() const noexcept -> char const* { return m_chars + m_size; }
+
+        constexpr auto view() const noexcept -> std::string_view { return { m_chars, m_size }; }
+        constexpr operator std::string_view() const noexcept { return view(); }
+
+        // Only when a std::string is really wanted - this allocates, if it's past SSO
+        auto str() const -> std::string { return std::string( view() ); }
+
+        friend constexpr auto operator==( DecimalString const& lhs, DecimalString const& rhs ) noexcept -> bool { return lhs.view() == rhs.view(); }
+        friend constexpr auto operator!=( DecimalString const& lhs, DecimalString const& rhs ) noexcept -> bool { return lhs.view() != rhs.view(); }
+        friend constexpr auto operator==( DecimalString const& lhs, std::string_view rhs ) noexcept -> bool { return lhs.view() == rhs; }
+        friend constexpr auto operator!=( DecimalString const& lhs, std::string_view rhs ) noexcept -> bool { return lhs.view() != rhs; }
+        friend constexpr auto operator==( std::string_view lhs, DecimalString const& rhs ) noexcept -> bool { return lhs == rhs.view(); }
+        friend constexpr auto operator!=( std::string_view lhs, DecimalString const& rhs ) noexcept -> bool { return lhs != rhs.view(); }
+    };
+
+    // e.g. to_decimal_string( 42 ), which holds up to maxDecimalLength<int> chars, or, to leave room for a prefix,
+    // to_decimal_string<16>( ":-) ", 42 )
+    template<typename T>
+    constexpr auto to_decimal_string( T value ) -> DecimalString<maxDecimalLength<T>> {
+        static_assert( std::is_integral_v<T>, "to_decimal_string needs an integer type" );
+        return { {}, value };
+    }
+    template<std::size_t Capacity, typename T>
+    constexpr auto to_decimal_string( std::string_view prefix, T value ) -> DecimalString<Capacity> {
+        static_assert( std::is_integral_v<T>, "to_decimal_string needs an integer type" );
+        return { prefix, value };
+    }
+
+    // Formats a number after a constant prefix, e.g. ":-) 42", in one pass - the prefix's length is worked out
+    // once, here, and each result is built at its final size (so one allocation at most, instead of
+    // prefix + std::to_string's temporaries). Holds a view of the prefix, which must outlive it
+    class PrefixedDecimal {
+        std::string_view m_prefix;
+
+    public:
+        explicit constexpr PrefixedDecimal( std::string_view prefix ) noexcept : m_prefix( prefix ) {}
+
+        constexpr auto prefix() const noexcept -> std::string_view { return m_prefix; }
+
+        template<typename T>
+        constexpr auto length( T value ) const -> std::size_t {
+            return m_prefix.size() + decimal_length( value );
+        }
+
+        // Writes exactly length( value ) chars at out and returns the end
+        template<typename T>
+        constexpr auto write( char* out, T value ) const -> char* {
+            for( char c : m_prefix )
+                *out++ = c;
+            return write_decimal( out, value );
+        }
+
+        // So it can be passed straight to std::transform
+        template<typename T>
+        auto operator()( T value ) const -> std::string {
+            std::string s( length( value ), '\0' );
+            write( s.data(), value );
+            return s;
+        }
+    };
+
+    // Total characters for a whole range - lets bulk conversions size their output once, up front
+    template<typename It>
+    auto total_decimal_length( It first, It last ) -> std::size_t {
+        std::size_t total = 0;
+        for(; first != last; ++first )
+            total += decimal_length( *first );
+        return total;
+    }
+
+    // Many 32 bit values at once: eight at a time with SIMD - multiply-shift division by powers of ten,
+    // then the digits are unpacked and packed into place with shuffles (AVX2, or two SSE2 halves).
+    // Writes the same chars as write_decimal for each value, back to back, and returns the end.
+    // If ends isn't null, ends[i] is offset plus the number of chars written up to the end of values[i].
+    // Asking for more than the CPU has falls back to what it does have
+    auto write_decimals( std::int32_t const* values, std::size_t count, char* out, std::size_t* ends = nullptr, std::size_t offset = 0 ) -> char*;
+    auto write_decimals( std::uint32_t const* values, std::size_t count, char* out, std::size_t* ends = nullptr, std::size_t offset = 0 ) -> char*;
+    auto write_decimals( std::int32_t const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset, SimdLevel level ) -> char*;
+    auto write_decimals( std::uint32_t const* values, std::size_t count, char* out, std::size_t* ends, std::size_t offset, SimdLevel level ) -> char*;
+
+    // Bulk conversion of ints to strings, e.g. to_strings( fib ) - every string is built at its final size
+    template<typename Range>
+    auto to_strings( Range const& values ) -> std::vector<std::string> {
+        std::vector<std::string> result;
+        result.reserve( std::size( values ) );
+        for( auto value : values ) {
+            auto& s = result.emplace_back( decimal_length( value ), '\0' );
+            write_decimal( s.data(), value );
+        }
+        return result;
+    }
+
+    // All of them in one string, separated (e.g. a CSV line) - a single allocation
+    template<typename Range>
+    auto to_delimited_text( Range const& values, char separator ) -> std::string {
+        auto first = std::begin( values ), last = std::end( values );
+        std::size_t count = std::size( values );
+        std::string text( total_decimal_length( first, last ) + ( count > 0 ? count - 1 : 0 ), '\0' );
+        char* out = text.data();
+        for( auto it = first; it != last; ++it ) {
+            if( it != first )
+                *out++ = separator;
+            out = write_decimal( out, *it );
+        }
+        return text;
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace Cpp17 {
+
+    // Reference counting policies for RefCounted
+
+    // For objects that never leave one thread - plain increments and decrements
+    struct SingleThreaded {
+        using Count = std::size_t;
+        struct Mutex {
+            void lock() noexcept {}
+            void unlock() noexcept {}
+        };
+
+        static void increment( Count& count ) noexcept { ++count; }
+        // true if that was the last reference
+        static auto decrement( Count& count ) noexcept -> bool { return --count == 0; }
+        static auto increment_if_nonzero( Count& count ) noexcept -> bool { return count != 0 && ++count; }
+        static auto load( Count const& count ) noexcept -> std::size_t { return count; }
+    };
+
+    // For objects shared between threads - what std::shared_ptr always pays for
+    struct ThreadSafe {
+        using Count = std::atomic<std::size_t>;
+        using Mutex = std::mutex;
+
+        static void increment( Count& count ) noexcept { count.fetch_add( 1, std::memory_order_relaxed ); }
+        static auto decrement( Count& count ) noexcept -> bool { return count.fetch_sub( 1, std::memory_order_acq_rel ) == 1; }
+        static auto increment_if_nonzero( Count& count ) noexcept -> bool {
+            auto current = count.load( std::memory_order_relaxed );
+            while( current != 0 )
+                if( count.compare_exchange_weak( current, current + 1, std::memory_order_relaxed ) )
+                    return true;
+            return false;
+        }
+        static auto load( Count const& count ) noexcept -> std::size_t { return count.load( std::memory_order_relaxed ); }
+    };
+
+    template<typename T> class IntrusivePtr;
+    template<typename T> class WeakRef;
+
+    namespace detail {
+        // Only made if a WeakRef is taken. It outlives the object, for as long as any WeakRef holds it,
+        // and is cleared (under its mutex) just before the object is deleted
+        template<typename Policy>
+        struct WeakAnchor {
+            typename Policy::Count refs{ 1 }; // one for the object itself, plus one per WeakRef
+            typename Policy::Mutex mutex;
+            void const* object;
+
+            explicit WeakAnchor( void const* object ) : object( object ) {}
+
+            void release() noexcept {
+                if( Policy::decrement( refs ) )
+                    delete this;
+            }
+        };
+    }
+
+    // Base class that puts the reference count in the object itself - so an IntrusivePtr is just one pointer,
+    // and there's no separate control block to allocate, or to miss in the cache.
+    // e.g. class Node : public RefCounted<> {...}, or RefCounted<ThreadSafe> if it's going to be shared between threads
+    template<typename Policy = SingleThreaded>
+    class RefCounted {
+        template<typename> friend class IntrusivePtr;
+        template<typename> friend class WeakRef;
+
+        mutable typename Policy::Count m_refs{ 0 };
+        mutable std::atomic<detail::WeakAnchor<Policy>*> m_anchor{ nullptr };
+
+    protected:
+        RefCounted() = default;
+        // A copy is a new object, with no references yet
+        RefCounted( RefCounted const& ) noexcept {}
+        auto operator=( RefCounted const& ) noexcept -> RefCounted& { return *this; }
+        ~RefCounted() = default;
+
+    public:
+        using ref_count_policy = Policy;
+
+        auto use_count() const noexcept -> std::size_t { return Policy::load( m_refs ); }
+    };
+
+    // Like std::shared_ptr, but for RefCounted objects
+    template<typename T>
+    class IntrusivePtr {
+        template<typename> friend class IntrusivePtr;
+        template<typename> friend class WeakRef;
+
+        using Policy = typename T::ref_count_policy;
+        using Base = RefCounted<Policy>;
+
+        T* m_object = nullptr;
+
+        struct Adopt {};
+        IntrusivePtr( T* object, Adopt ) noexcept : m_object( object ) {}
+
+        static void add_ref( T* object ) noexcept {
+            if( object )
+                Policy::increment( static_cast<Base const*>( object )->m_refs );
+        }
+        static void release( T* object ) noexcept {
+            if( !object )
+                return;
+            auto const* base = static_cast<Base const*>( object );
+            if( !Policy::decrement( base->m_refs ) )
+                return;
+            if( auto* anchor = base->m_anchor.load( std::memory_order_acquire ) ) {
+                {
+                    std::lock_guard lock( anchor->mutex );
+                    anchor->object = nullptr;
+                }
+                anchor->release();
+            }
+            delete object;
+        }
+
+    public:
+        using element_type = T;
+
+        IntrusivePtr() noexcept = default;
+        IntrusivePtr( std::nullptr_t ) noexcept {}
+        // Takes a reference to an object (e.g. straight from new)
+        explicit IntrusivePtr( T* object ) noexcept : m_object( object ) { add_ref( m_object ); }
+
+        IntrusivePtr( IntrusivePtr const& other ) noexcept : m_object( other.m_object ) { add_ref( m_object ); }
+        IntrusivePtr( IntrusivePtr&& other ) noexcept : m_object( std::exchange( other.m_object, nullptr ) ) {}
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        IntrusivePtr( IntrusivePtr<U> const& other ) noexcept : m_object( other.m_object ) { add_ref( m_object ); }
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        IntrusivePtr( IntrusivePtr<U>&& other ) noexcept : m_object( std::exchange( other.m_object, nullptr ) ) {}
+
+        ~IntrusivePtr() { release( m_object ); }
+
+        auto operator=( IntrusivePtr other ) noexcept -> IntrusivePtr& {
+            std::swap( m_object, other.m_object );
+            return *this;
+        }
+
+        void reset() noexcept { release( std::exchange( m_object, nullptr ) ); }
+
+        auto get() const noexcept -> T* { return m_object; }
+        auto operator*() const noexcept -> T& { return *m_object; }
+        auto operator->() const noexcept -> T* { return m_object; }
+        explicit operator bool() const noexcept { return m_object != nullptr; }
+
+        auto use_count() const noexcept -> std::size_t { return m_object ? m_object->use_count() : 0; }
+
+        friend auto operator==( IntrusivePtr const& lhs, IntrusivePtr const& rhs ) noexcept -> bool { return lhs.m_object == rhs.m_object; }
+        friend auto operator!=( IntrusivePtr const& lhs, IntrusivePtr const& rhs ) noexcept -> bool { return lhs.m_object != rhs.m_object; }
+    };
+
+    // Doesn't keep the object alive - lock() gives an IntrusivePtr if it still is
+    template<typename T>
+    class WeakRef {
+        using Policy = typename T::ref_count_policy;
+        using Anchor = detail::WeakAnchor<Policy>;
+
+        Anchor* m_anchor = nullptr;
+        T* m_object = nullptr;
+
+        // The object's anchor, made the first time it's needed
+        static auto anchor_of( T* object ) -> Anchor* {
+            auto& slot = static_cast<RefCounted<Policy> const*>( object )->m_anchor;
+            Anchor* anchor = slot.load( std::memory_order_acquire );
+            if( !anchor ) {
+                auto* made = new Anchor( object );
+                if( slot.compare_exchange_strong( anchor, made, std::memory_order_acq_rel ) )
+                    anchor = made;
+                else
+                    delete made; // another thread got there first
+            }
+            Policy::increment( anchor->refs );
+            return anchor;
+        }
+
+    public:
+        WeakRef() noexcept = default;
+        WeakRef( IntrusivePtr<T> const& strong ) : m_anchor( strong ? anchor_of( strong.get() ) : nullptr ), m_object( strong.get() ) {}
+
+        WeakRef( WeakRef const& other ) noexcept : m_anchor( other.m_anchor ), m_object( other.m_object ) {
+            if( m_anchor )
+                Policy::increment( m_anchor->refs );
+        }
+        WeakRef( WeakRef&& other ) noexcept
+        :   m_anchor( std::exchange( other.m_anchor, nullptr ) ),
+            m_object( std::exchange( other.m_object, nullptr ) )
+        {}
+        auto operator=( WeakRef other ) noexcept -> WeakRef& {
+            std::swap( m_anchor, other.m_anchor );
+            std::swap( m_object, other.m_object );
+            return *this;
+        }
+        ~WeakRef() {
+            if( m_anchor )
+                m_anchor->release();
+        }
+
+        auto lock() const -> IntrusivePtr<T> {
+            if( !m_anchor )
+                return {};
+            std::lock_guard lock( m_anchor->mutex );
+            if( m_anchor->object && Policy::increment_if_nonzero( static_cast<RefCounted<Policy> const*>( m_object )->m_refs ) )
+                return IntrusivePtr<T>( m_object, typename IntrusivePtr<T>::Adopt() );
+            return {};
+        }
+
+        auto expired() const -> bool { return !lock(); }
+    };
+
+    // e.g. make_intrusive<Node>( args... ), forwarding the args to the constructor, like make_unique
+    template<typename T, typename... Args>
+    auto make_intrusive( Args&&... args ) -> IntrusivePtr<T> {
+        return IntrusivePtr<T>( new T( std::forward<Args>( args )... ) );
+    }
+
+    // Makes any class RefCounted, e.g. make_intrusive<Counted<MyClass>>( "Harry", data )
+    template<typename T, typename Policy = SingleThreaded>
+    class Counted : public T, public RefCounted<Policy> {
+    public:
+        using T::T;
+        Counted() = default;
+        Counted( T const& value ) : T( value ) {}
+        Counted( T&& value ) : T( std::move( value ) ) {}
+    };
+}
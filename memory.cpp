@@ -1,5 +1,25 @@
 #include "catch.hpp"
+#include "allocation_counter.h"
+#include "intrusive_ptr.h"
+#include "object_pool.h"
+#include "relocating_vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 namespace Cpp98 {
     class MyClass {
@@ -14,6 +34,10 @@ namespace Cpp98 {
         size_t size() const { return m_data.size(); }
     };
 }
+namespace Cpp17 {
+    class FrozenMyClass;
+}
+
 namespace Cpp11 {
 
     template<typename T>
@@ -74,7 +98,162 @@ namespace Cpp11 {
         std::string data( int i ) const { return m_data.at(i); }
 
         size_t size() const { return m_data.size(); }
+
+        friend class Cpp17::FrozenMyClass;
+    };
+}
+
+namespace Cpp17 {
+
+    // Cpp11::MyClass, but allocator aware: the name, the vector and every string in it come from one
+    // std::pmr::memory_resource (the default one - normally the heap - unless you pass one, e.g. an Arena).
+    // Being allocator aware, std::pmr containers of them pass their own resource down to each one
+    class MyClass {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    private:
+        std::pmr::string m_name;
+        std::pmr::vector<std::pmr::string> m_data;
+
+    public:
+        MyClass( std::string_view name, std::initializer_list<std::string_view> data, allocator_type alloc = {} )
+        :   m_name( name, alloc ),
+            m_data( alloc )
+        {
+            m_data.reserve( data.size() );
+            for( auto item : data )
+                m_data.emplace_back( item );
+        }
+
+        // Copies and moves into a given resource (a move between different resources copies)
+        MyClass( MyClass const& other, allocator_type alloc = {} )
+        :   m_name( other.m_name, alloc ),
+            m_data( other.m_data, alloc )
+        {}
+        MyClass( MyClass&& other ) noexcept = default;
+        MyClass( MyClass&& other, allocator_type alloc )
+        :   m_name( std::move( other.m_name ), alloc ),
+            m_data( std::move( other.m_data ), alloc )
+        {}
+        auto operator=( MyClass const& ) -> MyClass& = default;
+        auto operator=( MyClass&& ) -> MyClass& = default;
+
+        auto get_allocator() const -> allocator_type { return m_name.get_allocator(); }
+
+        void add( std::string_view item ) { m_data.emplace_back( item ); }
+
+        // Views, rather than copies, so reading doesn't allocate either
+        auto name() const -> std::string_view { return m_name; }
+        auto data( std::size_t i ) const -> std::string_view { return m_data.at( i ); }
+
+        auto size() const -> std::size_t { return m_data.size(); }
+    };
+
+    // Memory for one request. Allocations come from an inline buffer and then from bigger and bigger blocks
+    // from the heap, just by bumping a pointer. Deallocating does nothing - reset() releases it all at once,
+    // ready for the next request (destroy anything still using it first)
+    template<std::size_t InlineBytes = 16 * 1024>
+    class Arena {
+        alignas( std::max_align_t ) std::byte m_buffer[InlineBytes];
+        std::pmr::monotonic_buffer_resource m_resource{ m_buffer, InlineBytes };
+
+    public:
+        Arena() = default;
+        Arena( Arena const& ) = delete;
+        auto operator=( Arena const& ) -> Arena& = delete;
+
+        auto resource() noexcept -> std::pmr::memory_resource* { return &m_resource; }
+
+        void reset() noexcept { m_resource.release(); }
+    };
+
+    // A MyClass that won't change any more, packed into one allocation: the number of items, where the name
+    // and each item end, then all their chars, one after another. Reads are views into that, so never allocate
+    class FrozenMyClass {
+        using Offset = std::uint32_t;
+        static constexpr std::size_t header = 2;
+
+        // [item count][end of name][end of item 0]...[end of item n-1] then the chars
+        std::unique_ptr<Offset[]> m_block;
+
+        auto block_words() const noexcept -> std::size_t {
+            Offset const length = m_block[header + m_block[0] - 1];
+            return header + m_block[0] + ( length + sizeof( Offset ) - 1 ) / sizeof( Offset );
+        }
+        auto chars() const noexcept -> char const* {
+            return reinterpret_cast<char const*>( m_block.get() + header + m_block[0] );
+        }
+        // 0 for the name, then 1 + each item
+        auto string_at( std::size_t index ) const noexcept -> std::string_view {
+            Offset const begin = index == 0 ? 0 : m_block[index];
+            return { chars() + begin, m_block[index + 1] - begin };
+        }
+
+        template<typename ItemAt>
+        void pack( std::string_view name, std::size_t count, ItemAt itemAt ) {
+            std::size_t length = name.size();
+            for( std::size_t i = 0; i < count; ++i )
+                length += itemAt( i ).size();
+            if( length > std::numeric_limits<Offset>::max() || count > std::numeric_limits<Offset>::max() - header )
+                throw std::length_error( "FrozenMyClass: too big for 32 bit offsets" );
+
+            m_block.reset( new Offset[header + count + ( length + sizeof( Offset ) - 1 ) / sizeof( Offset )] );
+            m_block[0] = static_cast<Offset>( count );
+            char* out = reinterpret_cast<char*>( m_block.get() + header + count );
+            Offset end = 0;
+            auto append = [&]( std::size_t slot, std::string_view s ) {
+                std::memcpy( out + end, s.data(), s.size() );
+                end += static_cast<Offset>( s.size() );
+                m_block[slot] = end;
+            };
+            append( 1, name );
+            for( std::size_t i = 0; i < count; ++i )
+                append( header + i, itemAt( i ) );
+        }
+
+    public:
+        FrozenMyClass() = default;
+
+        // Takes everything from source, leaving it empty
+        explicit FrozenMyClass( Cpp11::MyClass&& source ) {
+            Cpp11::MyClass consumed( std::move( source ) ); // its memory goes when this does
+            pack( consumed.m_name, consumed.m_data.size(), [&]( std::size_t i ) -> std::string_view { return consumed.m_data[i]; } );
+        }
+        explicit FrozenMyClass( MyClass&& source ) {
+            MyClass consumed( std::move( source ) );
+            pack( consumed.name(), consumed.size(), [&]( std::size_t i ) { return consumed.data( i ); } );
+        }
+
+        // Copying is one allocation and one memcpy
+        FrozenMyClass( FrozenMyClass const& other ) {
+            if( other.m_block ) {
+                m_block.reset( new Offset[other.block_words()] );
+                std::memcpy( m_block.get(), other.m_block.get(), other.block_words() * sizeof( Offset ) );
+            }
+        }
+        FrozenMyClass( FrozenMyClass&& ) noexcept = default;
+        auto operator=( FrozenMyClass other ) noexcept -> FrozenMyClass& {
+            m_block.swap( other.m_block );
+            return *this;
+        }
+
+        auto name() const noexcept -> std::string_view { return m_block ? string_at( 0 ) : std::string_view(); }
+        auto data( std::size_t i ) const -> std::string_view {
+            if( i >= size() )
+                throw std::out_of_range( "FrozenMyClass::data" );
+            return string_at( i + 1 );
+        }
+
+        auto size() const noexcept -> std::size_t { return m_block ? m_block[0] : 0; }
     };
+
+    // Their members only point to what they own - so they relocate with memcpy as long as those members do
+    // (the strings don't, with libstdc++)
+    template<>
+    struct is_trivially_relocatable<Cpp11::MyClass> : all_trivially_relocatable<std::string, std::vector<std::string>> {};
+    template<>
+    struct is_trivially_relocatable<FrozenMyClass> : is_trivially_relocatable<std::unique_ptr<std::uint32_t[]>> {};
 }
 
 TEST_CASE( "Heap memory management" ) {
@@ -187,4 +366,692 @@ TEST_CASE( "Heap memory management" ) {
             auto obj = std::make_unique<Cpp11::MyClass>( "Harry", std::vector<std::string>{"first", "second"} );
         }
     }
+    SECTION( "C++17" ) {
+        using namespace Cpp17;
+
+        SECTION( "pmr - default resource" ) {
+            MyClass obj( "Harry", { "first", "second" } );
+            REQUIRE( obj.name() == "Harry" );
+            REQUIRE( obj.size() == 2 );
+            REQUIRE( obj.data( 1 ) == "second" );
+            REQUIRE( obj.get_allocator().resource() == std::pmr::get_default_resource() );
+        }
+
+        SECTION( "pmr - a whole request from an arena" ) {
+            Arena<> arena;
+            std::string const longName = "Harry, well past the small string optimisation";
+
+            // The vector hands its resource down to each MyClass it holds
+            auto build = [&]( std::pmr::memory_resource* resource ) {
+                std::pmr::vector<MyClass> objects( resource );
+                objects.reserve( 20 );
+                for( int i = 0; i < 20; ++i )
+                    objects.emplace_back( longName, std::initializer_list<std::string_view>{ "first, also well past the small string optimisation", "second" } );
+                return objects;
+            };
+
+            // How many allocations that takes depends on the library's small string size - but not in the arena
+            AllocationCounter heapAllocations;
+            build( std::pmr::get_default_resource() );
+            REQUIRE( heapAllocations.count() > 0 );
+
+            AllocationCounter arenaAllocations;
+            {
+                auto objects = build( arena.resource() );
+                REQUIRE( objects.back().name() == longName );
+                REQUIRE( objects.back().data( 0 ) == "first, also well past the small string optimisation" );
+                REQUIRE( objects.back().get_allocator().resource() == arena.resource() );
+                REQUIRE( arenaAllocations.count() == 0 );
+
+                AllocationCounter copyAllocations;
+                MyClass copy = objects.front(); // copy construction doesn't propagate the allocator...
+                REQUIRE( copy.get_allocator().resource() == std::pmr::get_default_resource() );
+                auto const heapCopy = copyAllocations.count();
+                REQUIRE( heapCopy > 0 );
+
+                MyClass arenaCopy( objects.front(), arena.resource() ); // ...unless asked to
+                REQUIRE( arenaCopy.get_allocator().resource() == arena.resource() );
+                REQUIRE( copyAllocations.count() == heapCopy ); // nothing more from the heap
+            }
+            arena.reset();
+        }
+
+        SECTION( "make_intrusive" ) {
+            // The count is in the object - so one allocation, like make_shared, but only a pointer to copy around
+            AllocationCounter allocations;
+            auto obj = make_intrusive<Counted<Cpp11::MyClass>>( "Harry", std::vector<std::string>{"first", "second"} );
+            auto obj2 = obj;
+            REQUIRE( obj2->name() == "Harry" );
+            REQUIRE( obj.use_count() == 2 );
+            REQUIRE( sizeof( obj ) == sizeof( void* ) );
+            REQUIRE( allocations.count() == 2 ); // the object and its vector - no control block
+        }
+    }
+}
+
+TEST_CASE( "Intrusive pointers" ) {
+
+    using namespace Cpp17;
+
+    struct Node : RefCounted<> {
+        int value;
+        int* destroyed;
+        Node( int value, int* destroyed ) : value( value ), destroyed( destroyed ) {}
+        ~Node() { ++*destroyed; }
+    };
+    int destroyed = 0;
+
+    SECTION( "the last reference destroys the object" ) {
+        auto node = make_intrusive<Node>( 42, &destroyed );
+        {
+            IntrusivePtr<Node> copy = node;
+            IntrusivePtr<Node> moved = std::move( copy );
+            REQUIRE( node.use_count() == 2 );
+            REQUIRE_FALSE( copy );
+        }
+        REQUIRE( node.use_count() == 1 );
+        node = nullptr;
+        REQUIRE( destroyed == 1 );
+    }
+
+    SECTION( "a raw pointer can be adopted again" ) {
+        // (which a shared_ptr can't do - it would make a second control block)
+        auto node = make_intrusive<Node>( 42, &destroyed );
+        IntrusivePtr<Node> again( node.get() );
+        REQUIRE( again.use_count() == 2 );
+        node.reset();
+        REQUIRE( again->value == 42 );
+        again.reset();
+        REQUIRE( destroyed == 1 );
+    }
+
+    SECTION( "weak references" ) {
+        auto node = make_intrusive<Node>( 42, &destroyed );
+        WeakRef<Node> weak = node;
+        WeakRef<Node> weak2 = weak;
+        REQUIRE( weak.lock()->value == 42 );
+        REQUIRE( node.use_count() == 1 );
+
+        node.reset();
+        REQUIRE( destroyed == 1 ); // the weak references don't keep it alive...
+        REQUIRE( weak.expired() ); // ...but still know it's gone
+        REQUIRE_FALSE( weak2.lock() );
+    }
+
+    SECTION( "shared between threads" ) {
+        struct Shared : RefCounted<ThreadSafe> {
+            int value = 42;
+        };
+        auto shared = make_intrusive<Shared>();
+        WeakRef<Shared> weak = shared;
+
+        std::atomic<int> locked{ 0 };
+        std::vector<std::thread> threads;
+        for( int i = 0; i < 4; ++i )
+            threads.emplace_back( [shared, weak, &locked] {
+                for( int j = 0; j < 10000; ++j ) {
+                    auto copy = shared;
+                    if( weak.lock() == copy )
+                        ++locked;
+                }
+            } );
+        for( auto& thread : threads )
+            thread.join();
+        REQUIRE( locked == 40000 );
+        REQUIRE( shared.use_count() == 1 );
+
+        shared.reset();
+        REQUIRE( weak.expired() );
+    }
+
+    SECTION( "derived to base" ) {
+        struct Base : RefCounted<> {
+            virtual ~Base() = default;
+            virtual auto name() const -> std::string { return "Base"; }
+        };
+        struct Derived : Base {
+            auto name() const -> std::string override { return "Derived"; }
+        };
+        IntrusivePtr<Base> base = make_intrusive<Derived>();
+        REQUIRE( base->name() == "Derived" );
+    }
+}
+
+TEST_CASE( "Intrusive pointers - speed", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    struct Node {
+        int value = 1;
+    };
+    using CountedNode = Counted<Node>;
+    using SharedNode = Counted<Node, ThreadSafe>;
+
+    // Copying and destroying, all in the cache
+    constexpr int copies = 1000;
+    auto copyAll = []( auto const& ptr ) {
+        std::vector<std::decay_t<decltype( ptr )>> ptrs;
+        ptrs.reserve( copies );
+        for( int i = 0; i < copies; ++i )
+            ptrs.push_back( ptr );
+        return ptrs.size();
+    };
+    auto shared = std::make_shared<Node>();
+    auto intrusive = make_intrusive<CountedNode>();
+    auto intrusiveThreadSafe = make_intrusive<SharedNode>();
+
+    BENCHMARK( "std::shared_ptr copy and destroy" ) {
+        return copyAll( shared );
+    };
+    BENCHMARK( "Cpp17::IntrusivePtr copy and destroy" ) {
+        return copyAll( intrusive );
+    };
+    BENCHMARK( "Cpp17::IntrusivePtr copy and destroy, atomic" ) {
+        return copyAll( intrusiveThreadSafe );
+    };
+
+    // Too many objects for the cache, visited in a random order, copying each pointer (touching the count)
+    // and reading the object. A shared_ptr made from new has its count in a separate allocation - two misses
+    constexpr int objects = 1 << 20;
+    std::vector<int> order( objects );
+    std::iota( order.begin(), order.end(), 0 );
+    std::shuffle( order.begin(), order.end(), std::mt19937( 42 ) );
+
+    auto visitAll = [&order]( auto const& ptrs ) {
+        long total = 0;
+        for( int i : order ) {
+            auto copy = ptrs[i];
+            total += copy->value;
+        }
+        return total;
+    };
+    auto makeAll = []( auto make ) {
+        std::vector<decltype( make() )> ptrs;
+        ptrs.reserve( objects );
+        for( int i = 0; i < objects; ++i )
+            ptrs.push_back( make() );
+        return ptrs;
+    };
+
+    auto sharedFromNew = makeAll( [] { return std::shared_ptr<Node>( new Node ); } );
+    BENCHMARK( "std::shared_ptr( new ) copy - cache misses" ) {
+        return visitAll( sharedFromNew );
+    };
+    sharedFromNew.clear();
+
+    auto madeShared = makeAll( [] { return std::make_shared<Node>(); } );
+    BENCHMARK( "std::make_shared copy - cache misses" ) {
+        return visitAll( madeShared );
+    };
+    madeShared.clear();
+
+    auto intrusives = makeAll( [] { return make_intrusive<CountedNode>(); } );
+    BENCHMARK( "Cpp17::make_intrusive copy - cache misses" ) {
+        return visitAll( intrusives );
+    };
+}
+
+TEST_CASE( "Pooled objects" ) {
+
+    using namespace Cpp17;
+
+    SECTION( "make_pooled forwards like make_unique" ) {
+        std::vector<std::string> data = { "first", "second" };
+
+        auto copied = make_pooled<Cpp11::MyClass>( "Harry", data ); // data copied in
+        REQUIRE( copied->name() == "Harry" );
+        REQUIRE( data.size() == 2 );
+
+        auto moved = make_pooled<Cpp11::MyClass>( "Harry", std::move( data ) );
+        REQUIRE( moved->size() == 2 );
+
+        Pooled<Cpp11::MyClass> empty;
+        REQUIRE_FALSE( empty );
+    }
+
+    SECTION( "memory is reused, without going back to new" ) {
+        struct Point { double x, y, z; };
+        void* first = make_pooled<Point>( Point{ 1, 2, 3 } ).get(); // destroyed straight away
+
+        AllocationCounter allocations;
+        auto point = make_pooled<Point>( Point{ 4, 5, 6 } );
+        REQUIRE( point.get() == first );
+        REQUIRE( point->z == 6 );
+        for( int i = 0; i < 1000; ++i )
+            make_pooled<Point>();
+        REQUIRE( allocations.count() == 0 );
+    }
+
+    SECTION( "freed on another thread" ) {
+        std::vector<Pooled<std::pair<int, int>>> objects;
+        for( int i = 0; i < 10000; ++i )
+            objects.push_back( make_pooled<std::pair<int, int>>( i, -i ) );
+        std::thread( [&]{ objects.clear(); } ).join();
+
+        // The other thread's blocks went back to the shared lists - so new objects come from there
+        AllocationCounter allocations;
+        for( int i = 0; i < 10000; ++i )
+            objects.push_back( make_pooled<std::pair<int, int>>( i, -i ) );
+        REQUIRE( allocations.count() == 0 ); // (the vector kept its capacity)
+        REQUIRE( objects.back()->second == -9999 );
+    }
+
+    SECTION( "a throwing constructor gives the memory back" ) {
+        struct Throws {
+            Throws() { throw std::runtime_error( "no" ); }
+        };
+        REQUIRE_THROWS_AS( make_pooled<Throws>(), std::runtime_error );
+    }
+
+    SECTION( "too big for the pool" ) {
+        struct Big { char bytes[4096]; };
+        auto big = make_pooled<Big>();
+        REQUIRE( big );
+    }
+
+    SECTION( "too aligned for the pool" ) {
+        struct alignas( 128 ) Aligned { int value; };
+        std::vector<Pooled<Aligned>> objects;
+        for( int i = 0; i < 100; ++i )
+            objects.push_back( make_pooled<Aligned>( Aligned{ i } ) );
+        for( auto const& obj : objects )
+            CHECK( reinterpret_cast<std::uintptr_t>( obj.get() ) % 128 == 0 );
+        REQUIRE( objects.back()->value == 99 );
+    }
+}
+
+TEST_CASE( "Pooled objects - speed", "[!benchmark]" ) {
+
+    struct Node {
+        Node* next;
+        int value;
+    };
+    unsigned const threads = std::max( 2u, std::thread::hardware_concurrency() );
+    constexpr int perThread = 10000;
+
+    // Every thread makes a batch of objects, then frees them - and again, a few times
+    auto onEveryThread = [threads]( auto&& work ) {
+        std::vector<std::thread> workers;
+        for( unsigned i = 0; i < threads; ++i )
+            workers.emplace_back( [&work] {
+                for( int round = 0; round < 4; ++round )
+                    work();
+            } );
+        for( auto& worker : workers )
+            worker.join();
+    };
+
+    BENCHMARK( "std::make_unique" ) {
+        onEveryThread( [] {
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.reserve( perThread );
+            for( int i = 0; i < perThread; ++i )
+                nodes.push_back( std::make_unique<Node>( Node{ nullptr, i } ) );
+        } );
+    };
+    BENCHMARK( "std::make_shared" ) {
+        onEveryThread( [] {
+            std::vector<std::shared_ptr<Node>> nodes;
+            nodes.reserve( perThread );
+            for( int i = 0; i < perThread; ++i )
+                nodes.push_back( std::make_shared<Node>( Node{ nullptr, i } ) );
+        } );
+    };
+    BENCHMARK( "Cpp17::make_pooled" ) {
+        onEveryThread( [] {
+            std::vector<Cpp17::Pooled<Node>> nodes;
+            nodes.reserve( perThread );
+            for( int i = 0; i < perThread; ++i )
+                nodes.push_back( Cpp17::make_pooled<Node>( Node{ nullptr, i } ) );
+        } );
+    };
+
+    // Made on one thread, freed on another - the case the shared lists are for
+    auto handOver = []( auto make ) {
+        using Handle = decltype( make( 0 ) );
+        std::vector<Handle> nodes;
+        nodes.reserve( perThread );
+        for( int i = 0; i < perThread; ++i )
+            nodes.push_back( make( i ) );
+        std::thread( [&nodes] { nodes.clear(); } ).join();
+    };
+    BENCHMARK( "std::make_unique, freed on another thread" ) {
+        handOver( []( int i ) { return std::make_unique<Node>( Node{ nullptr, i } ); } );
+    };
+    BENCHMARK( "Cpp17::make_pooled, freed on another thread" ) {
+        handOver( []( int i ) { return Cpp17::make_pooled<Node>( Node{ nullptr, i } ); } );
+    };
+}
+
+TEST_CASE( "pmr MyClass - speed", "[!benchmark]" ) {
+
+    // A request's worth of objects, built and then all dropped
+    constexpr int count = 1000;
+    std::string const name = "Harry, with a name longer than SSO";
+
+    BENCHMARK( "Cpp11::MyClass, heap" ) {
+        std::vector<Cpp11::MyClass> objects;
+        objects.reserve( count );
+        for( int i = 0; i < count; ++i )
+            objects.emplace_back( name, std::vector<std::string>{ "the first item, longer than SSO", "the second item, also longer than SSO" } );
+        return objects.size();
+    };
+    BENCHMARK( "Cpp17::MyClass, heap (default resource)" ) {
+        std::pmr::vector<Cpp17::MyClass> objects;
+        objects.reserve( count );
+        for( int i = 0; i < count; ++i )
+            objects.emplace_back( name, std::initializer_list<std::string_view>{ "the first item, longer than SSO", "the second item, also longer than SSO" } );
+        return objects.size();
+    };
+
+    // Too big for the stack
+    auto arenaOnHeap = std::make_unique<Cpp17::Arena<256 * 1024>>();
+    auto& arena = *arenaOnHeap;
+    BENCHMARK( "Cpp17::MyClass, arena" ) {
+        std::size_t size;
+        {
+            std::pmr::vector<Cpp17::MyClass> objects( arena.resource() );
+            objects.reserve( count );
+            for( int i = 0; i < count; ++i )
+                objects.emplace_back( name, std::initializer_list<std::string_view>{ "the first item, longer than SSO", "the second item, also longer than SSO" } );
+            size = objects.size();
+        }
+        arena.reset();
+        return size;
+    };
+}
+
+TEST_CASE( "Frozen MyClass" ) {
+
+    using namespace Cpp17;
+
+    std::string const longName = "Harry, well past the small string optimisation";
+
+    SECTION( "frozen from a Cpp11::MyClass" ) {
+        Cpp11::MyClass source( longName, { "first", "second, also well past the small string optimisation", "" } );
+
+        AllocationCounter allocations;
+        FrozenMyClass frozen( std::move( source ) );
+        REQUIRE( allocations.count() == 1 );
+        REQUIRE( source.size() == 0 );
+
+        REQUIRE( frozen.size() == 3 );
+        REQUIRE( frozen.name() == longName );
+        REQUIRE( frozen.data( 0 ) == "first" );
+        REQUIRE( frozen.data( 1 ) == "second, also well past the small string optimisation" );
+        REQUIRE( frozen.data( 2 ).empty() );
+        REQUIRE( allocations.count() == 1 ); // reading doesn't allocate
+        REQUIRE_THROWS_AS( frozen.data( 3 ), std::out_of_range );
+
+        // All in one block
+        REQUIRE( frozen.data( 0 ).data() == frozen.name().data() + frozen.name().size() );
+    }
+
+    SECTION( "frozen from a Cpp17::MyClass" ) {
+        MyClass source( longName, { "first" } );
+        source.add( "second" );
+        FrozenMyClass frozen( std::move( source ) );
+        REQUIRE( frozen.name() == longName );
+        REQUIRE( frozen.data( 1 ) == "second" );
+    }
+
+    SECTION( "copies" ) {
+        FrozenMyClass frozen( Cpp11::MyClass( longName, { "first", "second" } ) );
+
+        AllocationCounter allocations;
+        FrozenMyClass copy = frozen;
+        REQUIRE( allocations.count() == 1 );
+        REQUIRE( copy.name() == longName );
+        REQUIRE( copy.data( 1 ) == "second" );
+        REQUIRE( copy.name().data() != frozen.name().data() );
+
+        FrozenMyClass moved = std::move( copy );
+        REQUIRE( moved.size() == 2 );
+        REQUIRE( copy.size() == 0 );
+        REQUIRE( copy.name().empty() );
+    }
+
+    SECTION( "no items" ) {
+        FrozenMyClass frozen( Cpp11::MyClass( "", {} ) );
+        REQUIRE( frozen.size() == 0 );
+        REQUIRE( frozen.name().empty() );
+        REQUIRE( FrozenMyClass( frozen ).name().empty() );
+    }
+}
+
+TEST_CASE( "Frozen MyClass - speed", "[!benchmark]" ) {
+
+    constexpr int count = 1000;
+    std::string const name = "Harry, with a name longer than SSO";
+    auto make = [&name] {
+        return Cpp11::MyClass( name, { "the first item, longer than SSO", "the second item, also longer than SSO", "third" } );
+    };
+
+    std::vector<Cpp11::MyClass> objects;
+    std::vector<Cpp17::FrozenMyClass> frozen;
+    for( int i = 0; i < count; ++i ) {
+        objects.push_back( make() );
+        frozen.emplace_back( make() );
+    }
+
+    // Every name and item of every object
+    auto readAll = []( auto const& objects ) {
+        std::size_t chars = 0;
+        for( auto const& obj : objects ) {
+            chars += obj.name().size();
+            for( std::size_t i = 0; i < obj.size(); ++i )
+                chars += obj.data( static_cast<int>( i ) ).size();
+        }
+        return chars;
+    };
+    BENCHMARK( "Cpp11::MyClass reads" ) {
+        return readAll( objects );
+    };
+    BENCHMARK( "Cpp17::FrozenMyClass reads" ) {
+        return readAll( frozen );
+    };
+
+    BENCHMARK( "Cpp11::MyClass copies" ) {
+        std::vector<Cpp11::MyClass> copies;
+        copies.reserve( count );
+        for( auto const& obj : objects )
+            copies.emplace_back( obj.name(), std::vector<std::string>{ obj.data( 0 ), obj.data( 1 ), obj.data( 2 ) } );
+        return copies.size();
+    };
+    BENCHMARK( "Cpp17::FrozenMyClass copies" ) {
+        std::vector<Cpp17::FrozenMyClass> copies( frozen );
+        return copies.size();
+    };
+}
+
+namespace {
+    // Counts its moves - the first is marked as trivially relocatable, the second isn't
+    struct Relocatable {
+        static inline int moves = 0;
+        int value;
+        explicit Relocatable( int value ) : value( value ) {}
+        Relocatable( Relocatable&& other ) noexcept : value( other.value ) { ++moves; }
+        ~Relocatable() {}
+    };
+    struct Tracked {
+        static inline int moves = 0;
+        int value;
+        explicit Tracked( int value ) : value( value ) {}
+        Tracked( Tracked&& other ) noexcept : value( other.value ) { ++moves; }
+        ~Tracked() {}
+    };
+}
+
+template<>
+struct Cpp17::is_trivially_relocatable<Relocatable> : std::true_type {};
+
+TEST_CASE( "Relocating vector" ) {
+
+    using namespace Cpp17;
+
+    static_assert( is_trivially_relocatable_v<int> );
+    static_assert( is_trivially_relocatable_v<std::unique_ptr<int>> );
+    static_assert( is_trivially_relocatable_v<std::vector<std::string>> );
+    static_assert( is_trivially_relocatable_v<FrozenMyClass> );
+
+    std::string const longName = "Harry, well past the small string optimisation";
+
+    SECTION( "growing" ) {
+        RelocatingVector<Cpp11::MyClass> objects;
+        for( int i = 0; i < 100; ++i )
+            objects.emplace_back( longName + std::to_string( i ), std::vector<std::string>{ "first", "second" } );
+        REQUIRE( objects.size() == 100 );
+        REQUIRE( objects.capacity() >= 100 );
+        REQUIRE( objects[0].name() == longName + "0" );
+        REQUIRE( objects[99].name() == longName + "99" );
+        REQUIRE( objects[99].data( 1 ) == "second" );
+    }
+
+    SECTION( "inserting and erasing" ) {
+        // std::vector<Cpp11::MyClass> can't erase at all - it has no move assignment
+        RelocatingVector<Cpp11::MyClass> objects;
+        for( int i = 0; i < 4; ++i )
+            objects.emplace_back( std::to_string( i ), std::vector<std::string>{} );
+        auto names = [&objects] {
+            std::string names;
+            for( auto const& obj : objects )
+                names += obj.name();
+            return names;
+        };
+
+        objects.insert( objects.begin() + 2, Cpp11::MyClass( "a", {} ) ); // full, so this grows
+        objects.emplace( objects.begin(), "b", std::vector<std::string>{} );
+        objects.emplace( objects.end(), "c", std::vector<std::string>{} );
+        REQUIRE( names() == "b01a23c" );
+
+        auto next = objects.erase( objects.begin() + 3 );
+        REQUIRE( next->name() == "2" );
+        objects.erase( objects.begin(), objects.begin() + 2 );
+        objects.erase( objects.end() - 1 );
+        REQUIRE( names() == "123" );
+    }
+
+    SECTION( "an element of itself" ) {
+        RelocatingVector<std::vector<std::string>> items;
+        items.push_back( { longName } );
+        for( int i = 0; i < 10; ++i )
+            items.push_back( items.front() );
+        items.insert( items.begin(), items.back() );
+        REQUIRE( items.size() == 12 );
+        REQUIRE( items[0][0] == longName );
+        REQUIRE( items[11][0] == longName );
+    }
+
+    SECTION( "relocating with memcpy doesn't move" ) {
+        RelocatingVector<Relocatable> relocatable;
+        Relocatable::moves = 0;
+        for( int i = 0; i < 100; ++i )
+            relocatable.emplace_back( i );
+        relocatable.insert( relocatable.begin() + 10, Relocatable( -1 ) );
+        relocatable.erase( relocatable.begin() + 50 );
+        REQUIRE( Relocatable::moves == 1 ); // just into the insert
+        REQUIRE( relocatable[10].value == -1 );
+        REQUIRE( relocatable[50].value == 50 );
+
+        RelocatingVector<Tracked> tracked;
+        Tracked::moves = 0;
+        for( int i = 0; i < 100; ++i )
+            tracked.emplace_back( i );
+        tracked.erase( tracked.begin() + 50 );
+        REQUIRE( Tracked::moves > 100 ); // not marked as relocatable - so moved one by one
+        REQUIRE( tracked[50].value == 51 );
+
+        RelocatingVector<std::unique_ptr<int>> pointers;
+        for( int i = 0; i < 100; ++i )
+            pointers.push_back( std::make_unique<int>( i ) );
+        pointers.erase( pointers.begin() + 50 );
+        REQUIRE( *pointers[50] == 51 );
+        REQUIRE( *pointers.back() == 99 );
+    }
+
+    SECTION( "a copy that throws part way" ) {
+        static int live = 0; // so anything left undestroyed shows
+        struct Fragile {
+            bool throwOnCopy = false;
+            Fragile() { ++live; }
+            explicit Fragile( bool throwOnCopy ) : throwOnCopy( throwOnCopy ) { ++live; }
+            Fragile( Fragile const& other ) {
+                if( other.throwOnCopy )
+                    throw std::runtime_error( "copy" );
+                ++live;
+            }
+            Fragile( Fragile&& ) noexcept { ++live; }
+            ~Fragile() { --live; }
+        };
+        {
+            RelocatingVector<Fragile> fragile;
+            for( int i = 0; i < 5; ++i )
+                fragile.emplace_back();
+            fragile[3].throwOnCopy = true;
+
+            REQUIRE_THROWS_AS( RelocatingVector<Fragile>( fragile ), std::runtime_error );
+            RelocatingVector<Fragile> assigned;
+            REQUIRE_THROWS_AS( assigned = fragile, std::runtime_error );
+            REQUIRE_THROWS_AS( ( RelocatingVector<Fragile>{ Fragile(), Fragile(), Fragile( true ) } ), std::runtime_error );
+            REQUIRE( live == 5 );
+        }
+        REQUIRE( live == 0 );
+    }
+}
+
+TEST_CASE( "Relocating vector - speed", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    constexpr int count = 100000;
+    auto makeFrozen = [] {
+        return FrozenMyClass( Cpp11::MyClass( "Harry", { "first", "second" } ) );
+    };
+    FrozenMyClass const frozen = makeFrozen();
+
+    // Growing from empty - the elements are copies of one, so it's mostly the relocating being measured
+    auto pushAll = [&frozen]( auto vector ) {
+        for( int i = 0; i < count; ++i )
+            vector.push_back( frozen );
+        return vector.size();
+    };
+    BENCHMARK( "std::vector<FrozenMyClass> push_back" ) {
+        return pushAll( std::vector<FrozenMyClass>() );
+    };
+    BENCHMARK( "Cpp17::RelocatingVector<FrozenMyClass> push_back" ) {
+        return pushAll( RelocatingVector<FrozenMyClass>() );
+    };
+
+    auto pushVectors = []( auto vector ) {
+        for( int i = 0; i < count; ++i )
+            vector.emplace_back( 2, i );
+        return vector.size();
+    };
+    BENCHMARK( "std::vector<std::vector<int>> push_back" ) {
+        return pushVectors( std::vector<std::vector<int>>() );
+    };
+    BENCHMARK( "Cpp17::RelocatingVector<std::vector<int>> push_back" ) {
+        return pushVectors( RelocatingVector<std::vector<int>>() );
+    };
+
+    // Erasing from the middle, until half are gone
+    constexpr int erasable = 20000;
+    auto eraseMiddle = []( auto& vector ) {
+        while( vector.size() > erasable / 2 )
+            vector.erase( vector.begin() + static_cast<std::ptrdiff_t>( vector.size() / 2 ) );
+        return vector.size();
+    };
+    std::vector<FrozenMyClass> frozenVector( erasable, frozen );
+    RelocatingVector<FrozenMyClass> frozenRelocating;
+    for( int i = 0; i < erasable; ++i )
+        frozenRelocating.push_back( frozen );
+
+    BENCHMARK( "std::vector<FrozenMyClass> erase" ) {
+        auto vector = frozenVector;
+        return eraseMiddle( vector );
+    };
+    BENCHMARK( "Cpp17::RelocatingVector<FrozenMyClass> erase" ) {
+        auto vector = frozenRelocating;
+        return eraseMiddle( vector );
+    };
 }
@@ -0,0 +1,102 @@
+#include "object_pool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace Cpp17::detail {
+
+    namespace {
+
+        constexpr std::size_t batchSize = 64;         // blocks moved to or from the shared lists at once
+        constexpr std::size_t chunkBytes = 64 * 1024; // new memory is carved into blocks this much at a time
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Batch {
+            FreeBlock* head;
+            std::size_t count;
+        };
+
+        // Shared between threads. Chunks are never given back - the pool lives as long as the program
+        struct SharedList {
+            std::mutex mutex;
+            std::vector<Batch> batches;
+        };
+        SharedList sharedLists[poolSizeClasses];
+
+        struct ThreadCache {
+            FreeBlock* heads[poolSizeClasses] = {};
+            std::size_t counts[poolSizeClasses] = {};
+
+            // Splits a free list after its first keep blocks (the most recently freed - likely still in cache),
+            // returning the rest as a batch
+            auto split_off( int sizeClass, std::size_t keep ) -> Batch {
+                FreeBlock** link = &heads[sizeClass];
+                for( std::size_t i = 0; i < keep && *link; ++i )
+                    link = &( *link )->next;
+                Batch batch{ *link, counts[sizeClass] - std::min( keep, counts[sizeClass] ) };
+                *link = nullptr;
+                counts[sizeClass] -= batch.count;
+                return batch;
+            }
+
+            void give_back( int sizeClass, Batch batch ) {
+                std::lock_guard lock( sharedLists[sizeClass].mutex );
+                sharedLists[sizeClass].batches.push_back( batch );
+            }
+
+            void refill( int sizeClass ) {
+                {
+                    auto& shared = sharedLists[sizeClass];
+                    std::lock_guard lock( shared.mutex );
+                    if( !shared.batches.empty() ) {
+                        heads[sizeClass] = shared.batches.back().head;
+                        counts[sizeClass] = shared.batches.back().count;
+                        shared.batches.pop_back();
+                        return;
+                    }
+                }
+                // Nothing spare anywhere - carve up a new chunk (operator new's alignment covers every block size)
+                std::size_t const blockSize = poolBlockSizes[sizeClass];
+                auto* chunk = static_cast<char*>( ::operator new( chunkBytes ) );
+                for( std::size_t offset = chunkBytes - blockSize;; offset -= blockSize ) {
+                    auto* block = reinterpret_cast<FreeBlock*>( chunk + offset );
+                    block->next = heads[sizeClass];
+                    heads[sizeClass] = block;
+                    ++counts[sizeClass];
+                    if( offset < blockSize )
+                        break;
+                }
+            }
+
+            ~ThreadCache() {
+                for( int sizeClass = 0; sizeClass < poolSizeClasses; ++sizeClass )
+                    if( counts[sizeClass] > 0 )
+                        give_back( sizeClass, split_off( sizeClass, 0 ) );
+            }
+        };
+
+        thread_local ThreadCache cache;
+    }
+
+    auto pool_allocate( int sizeClass ) -> void* {
+        if( !cache.heads[sizeClass] )
+            cache.refill( sizeClass );
+        FreeBlock* block = cache.heads[sizeClass];
+        cache.heads[sizeClass] = block->next;
+        --cache.counts[sizeClass];
+        return block;
+    }
+
+    void pool_deallocate( void* p, int sizeClass ) noexcept {
+        auto* block = static_cast<FreeBlock*>( p );
+        block->next = cache.heads[sizeClass];
+        cache.heads[sizeClass] = block;
+        // Keep one batch in hand, so a thread alternating allocating and freeing doesn't hit the lock every time
+        if( ++cache.counts[sizeClass] >= 2 * batchSize )
+            cache.give_back( sizeClass, cache.split_off( sizeClass, batchSize ) );
+    }
+}
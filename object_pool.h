@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Cpp17 {
+
+    namespace detail {
+        // Blocks come in these sizes - anything bigger (or more aligned than max_align_t) just uses new
+        inline constexpr std::size_t poolBlockSizes[] = { 16, 32, 64, 128, 256, 512 };
+        inline constexpr int poolSizeClasses = static_cast<int>( std::size( poolBlockSizes ) );
+
+        constexpr auto pool_size_class( std::size_t size, std::size_t alignment ) -> int {
+            if( alignment > alignof( std::max_align_t ) )
+                return -1;
+            for( int sizeClass = 0; sizeClass < poolSizeClasses; ++sizeClass )
+                if( size <= poolBlockSizes[sizeClass] )
+                    return sizeClass;
+            return -1;
+        }
+
+        // Each thread keeps its own free list per size class, so these usually take no lock.
+        // A thread that frees more than it allocates (e.g. a consumer of objects made on another thread)
+        // hands the surplus back to a shared list a whole batch at a time, for any thread to pick up
+        auto pool_allocate( int sizeClass ) -> void*;
+        void pool_deallocate( void* block, int sizeClass ) noexcept;
+
+        template<typename T>
+        inline constexpr int pool_size_class_of = pool_size_class( sizeof( T ), alignof( T ) );
+
+        // For what the pool doesn't take - over aligned types need the aligned forms of new and delete
+        template<typename T>
+        auto unpooled_allocate() -> void* {
+            if constexpr( alignof( T ) > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+                return ::operator new( sizeof( T ), std::align_val_t( alignof( T ) ) );
+            else
+                return ::operator new( sizeof( T ) );
+        }
+        template<typename T>
+        void unpooled_deallocate( void* p ) noexcept {
+            if constexpr( alignof( T ) > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+                ::operator delete( p, std::align_val_t( alignof( T ) ) );
+            else
+                ::operator delete( p );
+        }
+    }
+
+    // Destroys the object, then gives its memory back to the pool.
+    // Deliberately not convertible from PoolDeleter<Derived> - the block size comes from T
+    template<typename T>
+    struct PoolDeleter {
+        void operator()( T* p ) const noexcept {
+            static_assert( sizeof( T ) > 0, "can't delete an incomplete type" );
+            p->~T();
+            if constexpr( detail::pool_size_class_of<T> >= 0 )
+                detail::pool_deallocate( p, detail::pool_size_class_of<T> );
+            else
+                detail::unpooled_deallocate<T>( p );
+        }
+    };
+
+    template<typename T>
+    using Pooled = std::unique_ptr<T, PoolDeleter<T>>;
+
+    // Like make_unique (forwarding each argument just the same), but the memory comes from a pool of
+    // same-sized blocks, not from new
+    template<typename T, typename... Args>
+    auto make_pooled( Args&&... args ) -> Pooled<T> {
+        constexpr int sizeClass = detail::pool_size_class_of<T>;
+        void* block = sizeClass >= 0 ? detail::pool_allocate( sizeClass ) : detail::unpooled_allocate<T>();
+        try {
+            return Pooled<T>( new( block ) T( std::forward<Args>( args )... ) );
+        }
+        catch( ... ) {
+            if constexpr( sizeClass >= 0 )
+                detail::pool_deallocate( block, sizeClass );
+            else
+                detail::unpooled_deallocate<T>( block );
+            throw;
+        }
+    }
+}
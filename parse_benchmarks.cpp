@@ -0,0 +1,184 @@
+#include "catch.hpp"
+#include "string_conversions.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+// Throughput of every string to int strategy in string_conversions.cpp, plus the C and C++17 library options.
+// Run with: GrandParent "[throughput]" (optionally --benchmark-samples 20 to be quicker)
+// Each benchmark run parses exactly one value, so the listener below can report ns/value and values/sec.
+// Set GRANDPARENT_INVALID_RATIO (0 to 1, default 0.1) to change how much of the input is bad
+
+namespace {
+
+    // Collects the per value means and prints them as a table once the test case is done
+    struct ThroughputListener : Catch::TestEventListenerBase {
+        using TestEventListenerBase::TestEventListenerBase;
+
+        bool m_perValue = false;
+        std::vector<std::pair<std::string, double>> m_results;
+
+        void testCaseStarting( Catch::TestCaseInfo const& info ) override {
+            TestEventListenerBase::testCaseStarting( info );
+            m_perValue = std::find( info.lcaseTags.begin(), info.lcaseTags.end(), "throughput" ) != info.lcaseTags.end();
+            m_results.clear();
+        }
+
+        void benchmarkEnded( Catch::BenchmarkStats<> const& stats ) override {
+            if( m_perValue )
+                m_results.emplace_back( stats.info.name, stats.mean.point.count() );
+        }
+
+        void testCaseEnded( Catch::TestCaseStats const& stats ) override {
+            if( !m_results.empty() ) {
+                stream << "\n" << std::left << std::setw( 62 ) << "strategy" << std::right
+                       << std::setw( 12 ) << "ns/value" << std::setw( 16 ) << "values/sec" << "\n";
+                for( auto const& [name, nsPerValue] : m_results )
+                    stream << std::left << std::setw( 62 ) << name << std::right << std::fixed
+                           << std::setprecision( 2 ) << std::setw( 12 ) << nsPerValue
+                           << std::setprecision( 0 ) << std::setw( 16 ) << 1e9 / nsPerValue << "\n";
+                stream << std::defaultfloat << std::endl;
+            }
+            TestEventListenerBase::testCaseEnded( stats );
+        }
+    };
+
+    struct InputProfile {
+        std::string name;
+        int minDigits, maxDigits;
+        double negativeRatio;
+    };
+
+    auto invalid_ratio() -> double {
+        if( auto env = std::getenv( "GRANDPARENT_INVALID_RATIO" ) )
+            if( auto ratio = Cpp17::parse_double( env ) )
+                return std::clamp( *ratio, 0.0, 1.0 );
+        return 0.1;
+    }
+
+    auto make_inputs( InputProfile const& profile, double invalidRatio, std::size_t count ) -> std::vector<std::string> {
+        std::mt19937_64 rng( 7 );
+        std::uniform_int_distribution<int> digitCount( profile.minDigits, profile.maxDigits );
+        std::uniform_int_distribution<int> digit( 0, 9 );
+        std::uniform_real_distribution<double> chance( 0.0, 1.0 );
+
+        std::vector<std::string> inputs;
+        inputs.reserve( count );
+        while( inputs.size() < count ) {
+            std::string s;
+            if( chance( rng ) < profile.negativeRatio )
+                s += '-';
+            s += static_cast<char>( '1' + digit( rng ) % 9 );
+            for( int n = digitCount( rng ); n > 1; --n )
+                s += static_cast<char>( '0' + digit( rng ) );
+            if( chance( rng ) < invalidRatio )
+                s[ s.size() / 2 ] = 'x'; // Blakes7 style junk
+            inputs.push_back( std::move( s ) );
+        }
+        return inputs;
+    }
+
+    // Hot: a small set we go round and round in order, so it stays in L1.
+    // Cold: millions of strings visited in a random order, so almost every one is a cache miss
+    struct Workload {
+        std::string name;
+        std::vector<std::string> inputs;
+        std::vector<std::uint32_t> order;
+        std::uint32_t mask;
+    };
+
+    auto make_workload( InputProfile const& profile, double invalidRatio, bool cold ) -> Workload {
+        std::size_t count = cold ? ( 1u << 21 ) : ( 1u << 10 );
+        Workload workload{ profile.name + ( cold ? ", cold" : ", hot" ), make_inputs( profile, invalidRatio, count ), {}, static_cast<std::uint32_t>( count - 1 ) };
+        workload.order.resize( count );
+        for( std::uint32_t i = 0; i < count; ++i )
+            workload.order[i] = i;
+        if( cold )
+            std::shuffle( workload.order.begin(), workload.order.end(), std::mt19937( 11 ) );
+        return workload;
+    }
+
+    template<typename Parse>
+    void bench( Workload const& workload, std::string const& strategy, Parse parse ) {
+        BENCHMARK( workload.name + " - " + strategy, i ) {
+            return parse( workload.inputs[ workload.order[ static_cast<std::uint32_t>( i ) & workload.mask ] ] );
+        };
+    }
+
+    void bench_all( Workload const& workload ) {
+        using namespace Cpp17;
+
+        bench( workload, "C++98 stringstream", []( std::string const& s ) {
+            std::stringstream ss;
+            ss << s;
+            int i = 0;
+            ss >> i;
+            return ss.fail() ? 0 : i;
+        } );
+        bench( workload, "C++11 std::stoul", []( std::string const& s ) {
+            try {
+                return static_cast<int>( std::stoul( s ) );
+            }
+            catch( std::exception const& ) {
+                return 0;
+            }
+        } );
+        bench( workload, "C strtol", []( std::string const& s ) {
+            errno = 0;
+            char* end;
+            long value = std::strtol( s.c_str(), &end, 10 );
+            bool ok = end == s.c_str() + s.size() && errno == 0 &&
+                      value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max();
+            return ok ? static_cast<int>( value ) : 0;
+        } );
+        bench( workload, "std::from_chars", []( std::string const& s ) {
+            int i = 0;
+            auto [ptr, ec] = std::from_chars( s.data(), s.data() + s.size(), i );
+            return ec == std::errc() && ptr == s.data() + s.size() ? i : 0;
+        } );
+        bench( workload, "parse_int1 (out param)", []( std::string const& s ) {
+            int i = 0;
+            return parse_int1( s, i ) ? i : 0;
+        } );
+        bench( workload, "parse_int2 (optional)", []( std::string const& s ) {
+            return parse_int2( s ).value_or( 0 );
+        } );
+        bench( workload, "parse_int3 (variant)", []( std::string const& s ) {
+            auto result = parse_int3( s );
+            return result.index() == 0 ? std::get<int>( result ) : 0;
+        } );
+        bench( workload, "parse_int4 (expected)", []( std::string const& s ) {
+            auto result = parse_int4( s );
+            return result ? *result : 0;
+        } );
+    }
+}
+
+CATCH_REGISTER_LISTENER( ThroughputListener )
+
+TEST_CASE( "String to int throughput", "[!benchmark][throughput]" ) {
+
+    double invalidRatio = invalid_ratio();
+
+    InputProfile shortNumbers{ "short (1-3 digits)", 1, 3, 0.0 };
+    InputProfile longNumbers{ "long (7-9 digits)", 7, 9, 0.0 }; // 10 digits would mostly overflow
+    InputProfile signedNumbers{ "mixed, half negative", 1, 9, 0.5 };
+
+    SECTION( "short" ) {
+        bench_all( make_workload( shortNumbers, invalidRatio, false ) );
+    }
+    SECTION( "long" ) {
+        bench_all( make_workload( longNumbers, invalidRatio, false ) );
+    }
+    SECTION( "signed" ) {
+        bench_all( make_workload( signedNumbers, invalidRatio, false ) );
+    }
+    SECTION( "cold cache" ) {
+        bench_all( make_workload( signedNumbers, invalidRatio, true ) );
+    }
+}
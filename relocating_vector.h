@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Cpp17 {
+
+    // A type is trivially relocatable if moving it to new memory and destroying the original is the same as
+    // copying its bytes - and forgetting the original. Most types are, even with a user written move
+    // constructor (they just own pointers), but the language can't tell - so specialise this to say so.
+    // (Strictly, memcpy only makes new objects of trivially copyable types - this relies on what the compilers
+    // actually do, as P1144 proposes to standardise)
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    // For a class whose members are all trivially relocatable, e.g.
+    //     template<> struct is_trivially_relocatable<MyClass> : all_trivially_relocatable<std::string, std::vector<std::string>> {};
+    template<typename... Members>
+    using all_trivially_relocatable = std::conjunction<is_trivially_relocatable<Members>...>;
+
+    template<typename T>
+    struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+    template<typename T, typename Deleter>
+    struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : is_trivially_relocatable<Deleter> {};
+    template<typename T>
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+    template<typename T, typename Alloc>
+    struct is_trivially_relocatable<std::vector<T, Alloc>> : is_trivially_relocatable<Alloc> {};
+
+    // libstdc++'s short strings point into themselves, so moving the bytes would leave them pointing at the old
+    // object. libc++ just uses a flag
+    template<typename Char, typename Traits, typename Alloc>
+    struct is_trivially_relocatable<std::basic_string<Char, Traits, Alloc>>
+#ifdef _LIBCPP_VERSION
+        : is_trivially_relocatable<Alloc> {};
+#else
+        : std::false_type {};
+#endif
+
+    namespace detail {
+        // Moves count objects from from to to (the ranges may overlap), ending the lives of the originals
+        template<typename T>
+        void relocate( T* from, T* to, std::size_t count ) noexcept {
+            if( count == 0 || from == to )
+                return;
+            if constexpr( is_trivially_relocatable_v<T> ) {
+                std::memmove( static_cast<void*>( to ), static_cast<void const*>( from ), count * sizeof( T ) );
+            }
+            else if( to < from ) {
+                for( std::size_t i = 0; i < count; ++i ) {
+                    ::new( static_cast<void*>( to + i ) ) T( std::move( from[i] ) );
+                    from[i].~T();
+                }
+            }
+            else {
+                for( std::size_t i = count; i-- > 0; ) {
+                    ::new( static_cast<void*>( to + i ) ) T( std::move( from[i] ) );
+                    from[i].~T();
+                }
+            }
+        }
+    }
+
+    // Like std::vector, but growing, inserting and erasing relocate the elements: one memmove for trivially
+    // relocatable types, rather than a move and a destructor call for each one (std::vector also needs
+    // move assignment to erase - this doesn't).
+    // Elements must be trivially relocatable or nothrow move constructible, so relocating can't fail part way
+    template<typename T>
+    class RelocatingVector {
+        static_assert( is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>,
+                "RelocatingVector elements must be relocatable without throwing" );
+
+        T* m_data = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;
+
+        static auto allocate( std::size_t capacity ) -> T* {
+            return capacity == 0 ? nullptr : std::allocator<T>().allocate( capacity );
+        }
+        static void deallocate( T* data, std::size_t capacity ) noexcept {
+            if( data )
+                std::allocator<T>().deallocate( data, capacity );
+        }
+
+        auto grown_capacity() const -> std::size_t { return std::max<std::size_t>( 4, m_capacity * 2 ); }
+
+        void relocate_to( std::size_t capacity ) {
+            T* data = allocate( capacity );
+            detail::relocate( m_data, data, m_size );
+            deallocate( m_data, m_capacity );
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = T const*;
+        using reference = T&;
+        using const_reference = T const&;
+
+        RelocatingVector() noexcept = default;
+        // Delegating, so if a copy throws part way the destructor still frees what was made
+        RelocatingVector( std::initializer_list<T> values ) : RelocatingVector() {
+            reserve( values.size() );
+            for( auto const& value : values )
+                emplace_back( value );
+        }
+        RelocatingVector( RelocatingVector const& other ) : RelocatingVector() {
+            reserve( other.m_size );
+            for( auto const& value : other )
+                emplace_back( value );
+        }
+        RelocatingVector( RelocatingVector&& other ) noexcept
+        :   m_data( std::exchange( other.m_data, nullptr ) ),
+            m_size( std::exchange( other.m_size, 0 ) ),
+            m_capacity( std::exchange( other.m_capacity, 0 ) )
+        {}
+        auto operator=( RelocatingVector other ) noexcept -> RelocatingVector& {
+            swap( other );
+            return *this;
+        }
+        ~RelocatingVector() {
+            clear();
+            deallocate( m_data, m_capacity );
+        }
+
+        void swap( RelocatingVector& other ) noexcept {
+            std::swap( m_data, other.m_data );
+            std::swap( m_size, other.m_size );
+            std::swap( m_capacity, other.m_capacity );
+        }
+
+        void reserve( std::size_t capacity ) {
+            if( capacity > m_capacity )
+                relocate_to( capacity );
+        }
+
+        template<typename... Args>
+        auto emplace_back( Args&&... args ) -> T& {
+            if( m_size < m_capacity ) {
+                ::new( static_cast<void*>( m_data + m_size ) ) T( std::forward<Args>( args )... );
+            }
+            else {
+                // Made in the new memory before the old elements leave - args might refer to one of them
+                std::size_t const capacity = grown_capacity();
+                T* data = allocate( capacity );
+                try {
+                    ::new( static_cast<void*>( data + m_size ) ) T( std::forward<Args>( args )... );
+                }
+                catch( ... ) {
+                    deallocate( data, capacity );
+                    throw;
+                }
+                detail::relocate( m_data, data, m_size );
+                deallocate( m_data, m_capacity );
+                m_data = data;
+                m_capacity = capacity;
+            }
+            return m_data[m_size++];
+        }
+        void push_back( T const& value ) { emplace_back( value ); }
+        void push_back( T&& value ) { emplace_back( std::move( value ) ); }
+
+        template<typename... Args>
+        auto emplace( const_iterator pos, Args&&... args ) -> iterator {
+            std::size_t const index = static_cast<std::size_t>( pos - m_data );
+            if( m_size == m_capacity ) {
+                std::size_t const capacity = grown_capacity();
+                T* data = allocate( capacity );
+                try {
+                    ::new( static_cast<void*>( data + index ) ) T( std::forward<Args>( args )... );
+                }
+                catch( ... ) {
+                    deallocate( data, capacity );
+                    throw;
+                }
+                detail::relocate( m_data, data, index );
+                detail::relocate( m_data + index, data + index + 1, m_size - index );
+                deallocate( m_data, m_capacity );
+                m_data = data;
+                m_capacity = capacity;
+            }
+            else {
+                // Made on the side first, in case args refer to an element, or it throws
+                alignas( T ) std::byte made[sizeof( T )];
+                ::new( static_cast<void*>( made ) ) T( std::forward<Args>( args )... );
+                detail::relocate( m_data + index, m_data + index + 1, m_size - index );
+                detail::relocate( std::launder( reinterpret_cast<T*>( made ) ), m_data + index, 1 );
+            }
+            ++m_size;
+            return m_data + index;
+        }
+        auto insert( const_iterator pos, T const& value ) -> iterator { return emplace( pos, value ); }
+        auto insert( const_iterator pos, T&& value ) -> iterator { return emplace( pos, std::move( value ) ); }
+
+        auto erase( const_iterator first, const_iterator last ) -> iterator {
+            std::size_t const index = static_cast<std::size_t>( first - m_data );
+            std::size_t const count = static_cast<std::size_t>( last - first );
+            std::destroy( m_data + index, m_data + index + count );
+            detail::relocate( m_data + index + count, m_data + index, m_size - index - count );
+            m_size -= count;
+            return m_data + index;
+        }
+        auto erase( const_iterator pos ) -> iterator { return erase( pos, pos + 1 ); }
+
+        void pop_back() noexcept { m_data[--m_size].~T(); }
+        void clear() noexcept {
+            std::destroy( m_data, m_data + m_size );
+            m_size = 0;
+        }
+
+        auto size() const noexcept -> std::size_t { return m_size; }
+        auto capacity() const noexcept -> std::size_t { return m_capacity; }
+        auto empty() const noexcept -> bool { return m_size == 0; }
+
+        auto operator[]( std::size_t i ) noexcept -> T& { return m_data[i]; }
+        auto operator[]( std::size_t i ) const noexcept -> T const& { return m_data[i]; }
+        auto at( std::size_t i ) -> T& {
+            if( i >= m_size )
+                throw std::out_of_range( "RelocatingVector::at" );
+            return m_data[i];
+        }
+        auto at( std::size_t i ) const -> T const& {
+            if( i >= m_size )
+                throw std::out_of_range( "RelocatingVector::at" );
+            return m_data[i];
+        }
+        auto front() noexcept -> T& { return m_data[0]; }
+        auto back() noexcept -> T& { return m_data[m_size - 1]; }
+
+        auto data() noexcept -> T* { return m_data; }
+        auto data() const noexcept -> T const* { return m_data; }
+        auto begin() noexcept -> iterator { return m_data; }
+        auto end() noexcept -> iterator { return m_data + m_size; }
+        auto begin() const noexcept -> const_iterator { return m_data; }
+        auto end() const noexcept -> const_iterator { return m_data + m_size; }
+    };
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace Cpp17 {
+
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+    // Best level this CPU supports - checked once, at runtime
+    auto detected_simd_level() -> SimdLevel;
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "int_to_string.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Cpp17 {
+
+    // N strings packed into one buffer, plus the offset where each one ends.
+    // Two allocations, however many strings, and iterating walks memory in order.
+    // Elements are std::string_views into the buffer - they're invalidated when it grows
+    class StringColumn {
+        std::string m_chars;
+        std::vector<std::size_t> m_ends;
+
+    public:
+        using value_type = std::string_view;
+        using size_type = std::size_t;
+
+        class const_iterator {
+            StringColumn const* m_column = nullptr;
+            std::size_t m_index = 0;
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+            const_iterator() = default;
+            const_iterator( StringColumn const* column, std::size_t index ) : m_column( column ), m_index( index ) {}
+
+            auto operator*() const -> std::string_view { return ( *m_column )[m_index]; }
+            auto operator++() -> const_iterator& { ++m_index; return *this; }
+            auto operator++( int ) -> const_iterator { auto old = *this; ++m_index; return old; }
+            friend auto operator==( const_iterator const& lhs, const_iterator const& rhs ) -> bool { return lhs.m_index == rhs.m_index; }
+            friend auto operator!=( const_iterator const& lhs, const_iterator const& rhs ) -> bool { return lhs.m_index != rhs.m_index; }
+        };
+
+        StringColumn() = default;
+
+        // Adopts already packed strings - ends must be ascending, with the last one at chars.size()
+        StringColumn( std::string chars, std::vector<std::size_t> ends )
+        :   m_chars( std::move( chars ) ),
+            m_ends( std::move( ends ) )
+        {}
+
+        // Sizes both allocations up front, if you know (or can work out) the totals
+        void reserve( std::size_t count, std::size_t chars ) {
+            m_ends.reserve( count );
+            m_chars.reserve( chars );
+        }
+
+        // So std::back_inserter works - e.g. in std::transform
+        void push_back( std::string_view s ) {
+            m_chars.append( s );
+            m_ends.push_back( m_chars.size() );
+        }
+
+        // Adds a string of exactly length chars, written in place by write( char* )
+        template<typename Writer>
+        void append( std::size_t length, Writer&& write ) {
+            auto start = m_chars.size();
+            m_chars.resize( start + length );
+            write( m_chars.data() + start );
+            m_ends.push_back( m_chars.size() );
+        }
+
+        void clear() noexcept {
+            m_chars.clear();
+            m_ends.clear();
+        }
+
+        auto size() const noexcept -> std::size_t { return m_ends.size(); }
+        auto empty() const noexcept -> bool { return m_ends.empty(); }
+        auto chars() const noexcept -> std::string_view { return m_chars; }
+
+        auto operator[]( std::size_t i ) const -> std::string_view {
+            auto start = i == 0 ? 0 : m_ends[i-1];
+            return std::string_view( m_chars ).substr( start, m_ends[i] - start );
+        }
+
+        auto begin() const -> const_iterator { return { this, 0 }; }
+        auto end() const -> const_iterator { return { this, size() }; }
+
+        // Implicit, so Catch's Equals( std::vector<std::string> ) matcher can be used directly
+        // (it allocates every string - it's for tests, not for the hot path)
+        operator std::vector<std::string>() const {
+            return std::vector<std::string>( begin(), end() );
+        }
+
+        friend auto operator==( StringColumn const& column, std::vector<std::string> const& strings ) -> bool {
+            if( column.size() != strings.size() )
+                return false;
+            for( std::size_t i = 0; i < strings.size(); ++i )
+                if( column[i] != strings[i] )
+                    return false;
+            return true;
+        }
+        friend auto operator==( std::vector<std::string> const& strings, StringColumn const& column ) -> bool {
+            return column == strings;
+        }
+    };
+
+    // Ints to a StringColumn - exactly two allocations: one for the offsets, one for all the digits
+    template<typename Range>
+    auto to_string_column( Range const& values ) -> StringColumn {
+        if constexpr( detail::has_decimal_kernel<Range> ) {
+            std::string chars( total_decimal_length( std::begin( values ), std::end( values ) ), '\0' );
+            std::vector<std::size_t> ends( std::size( values ) );
+            write_decimals( std::data( values ), ends.size(), chars.data(), ends.data() );
+            return StringColumn( std::move( chars ), std::move( ends ) );
+        }
+        StringColumn column;
+        column.reserve( std::size( values ), total_decimal_length( std::begin( values ), std::end( values ) ) );
+        for( auto value : values )
+            column.append( decimal_length( value ), [value]( char* out ) { write_decimal( out, value ); } );
+        return column;
+    }
+
+    // Each value after the same prefix - still two allocations
+    template<typename Range>
+    auto to_string_column( Range const& values, PrefixedDecimal format ) -> StringColumn {
+        StringColumn column;
+        column.reserve( std::size( values ), total_decimal_length( std::begin( values ), std::end( values ) ) + std::size( values ) * format.prefix().size() );
+        for( auto value : values )
+            column.append( format.length( value ), [format, value]( char* out ) { format.write( out, value ); } );
+        return column;
+    }
+
+    // Same result as to_string_column, but formatted on several threads (0 means one per core).
+    // The input is split into one chunk per thread. A first pass works out how many chars each chunk needs,
+    // a running total of those gives every chunk its final position, then each thread writes its digits
+    // (and offsets) straight into place - so the output is the same, in the same order, however many threads
+    template<typename T>
+    auto to_string_column_parallel( std::vector<T> const& values, unsigned threads = 0 ) -> StringColumn {
+        if( threads == 0 )
+            threads = std::max( 1u, std::thread::hardware_concurrency() );
+        std::size_t const count = values.size();
+        std::size_t const chunks = std::max<std::size_t>( 1, std::min<std::size_t>( threads, count ) );
+        auto chunkStart = [&]( std::size_t chunk ) { return count / chunks * chunk + std::min( chunk, count % chunks ); };
+
+        auto inParallel = [chunks]( auto&& work ) {
+            std::vector<std::thread> workers;
+            workers.reserve( chunks - 1 );
+            auto joinAll = [&workers] {
+                for( auto& worker : workers )
+                    worker.join();
+            };
+            try {
+                for( std::size_t chunk = 1; chunk < chunks; ++chunk )
+                    workers.emplace_back( work, chunk );
+                work( std::size_t( 0 ) );
+            }
+            catch( ... ) {
+                joinAll(); // destroying a joinable thread would terminate
+                throw;
+            }
+            joinAll();
+        };
+
+        // 1. Exact size of each chunk's text
+        std::vector<std::size_t> chunkChars( chunks + 1, 0 );
+        inParallel( [&]( std::size_t chunk ) {
+            chunkChars[chunk + 1] = total_decimal_length( values.begin() + chunkStart( chunk ), values.begin() + chunkStart( chunk + 1 ) );
+        } );
+
+        // 2. Running total gives each chunk's offset in the output
+        std::partial_sum( chunkChars.begin(), chunkChars.end(), chunkChars.begin() );
+
+        // 3. Format straight into the final positions
+        std::string chars( chunkChars.back(), '\0' );
+        std::vector<std::size_t> ends( count );
+        inParallel( [&]( std::size_t chunk ) {
+            std::size_t offset = chunkChars[chunk];
+            if constexpr( detail::has_decimal_kernel<std::vector<T>> ) {
+                std::size_t const first = chunkStart( chunk );
+                write_decimals( values.data() + first, chunkStart( chunk + 1 ) - first, chars.data() + offset, ends.data() + first, offset );
+                return;
+            }
+            for( std::size_t i = chunkStart( chunk ), last = chunkStart( chunk + 1 ); i < last; ++i ) {
+                offset = static_cast<std::size_t>( write_decimal( chars.data() + offset, values[i] ) - chars.data() );
+                ends[i] = offset;
+            }
+        } );
+
+        return StringColumn( std::move( chars ), std::move( ends ) );
+    }
+}
@@ -1,29 +1,35 @@
 #include "catch.hpp"
+#include "string_conversions.h"
 
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <variant>
 
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <immintrin.h>
+#define GRANDPARENT_X86_SIMD
+#endif
+
 namespace Cpp17 {
 
     // Writing a conversion from string to int without exceptions
+    // (all of these go through parse_integer, in string_conversions.h - no stringstream, no locale, no allocation)
 
     // 1. take an out reference
     [[nodiscard]] // must check return value
     auto parse_int1( std::string_view sv, int& result ) -> bool {
-        std::stringstream ss;
-        ss << sv;
-        ss >> result;
-        return !ss.fail();
+        return parse_integer( sv, result ) == std::errc();
     }
 
     // 2. returning optional
     auto parse_int2( std::string_view sv ) -> std::optional<int> {
         int i;
-        std::stringstream ss;
-        ss << sv;
-        ss >> i;
-        if( !ss.fail() )
+        if( parse_integer( sv, i ) == std::errc() )
             return i;
         else
             return {};
@@ -32,14 +38,261 @@ namespace Cpp17 {
     // 3. returning variant
     auto parse_int3( std::string_view sv ) -> std::variant<int, std::domain_error> {
         int i;
-        std::stringstream ss;
-        ss << sv;
-        ss >> i;
-        if( !ss.fail() )
+        if( parse_integer( sv, i ) == std::errc() )
             return i;
         else
             return std::domain_error( "'" + std::string( sv ) + "' is not an integer" );
     }
+
+    // ...and the same three for other bases, e.g. parse_int2( "0x1F", 16 ) or parse_int2( "-0b101", 2 )
+    // (bases 2, 8 and 16 are converted eight digits at a time)
+
+    [[nodiscard]]
+    auto parse_int1( std::string_view sv, int& result, int base ) -> bool {
+        return parse_integer_with_prefix( sv, result, base ) == std::errc();
+    }
+
+    auto parse_int2( std::string_view sv, int base ) -> std::optional<int> {
+        int i;
+        if( parse_integer_with_prefix( sv, i, base ) == std::errc() )
+            return i;
+        else
+            return {};
+    }
+
+    auto parse_int3( std::string_view sv, int base ) -> std::variant<int, std::domain_error> {
+        int i;
+        if( parse_integer_with_prefix( sv, i, base ) == std::errc() )
+            return i;
+        else if( base < 2 || base > 36 )
+            return std::domain_error( "base " + std::to_string( base ) + " is not supported (must be 2 to 36)" );
+        else
+            return std::domain_error( "'" + std::string( sv ) + "' is not a base " + std::to_string( base ) + " integer" );
+    }
+
+    // 4. returning expected
+    // - the failure path is now as cheap as the success path: no allocation, no formatting
+    auto parse_int4( std::string_view sv ) -> Expected<int, ParseError> {
+        int i;
+        char const* last = sv.data() + sv.size();
+        auto [ptr, ec] = parse_integer( sv.data(), last, i );
+        if( ec == std::errc() && ptr == last )
+            return i;
+
+        auto offset = static_cast<std::uint32_t>( ptr - sv.data() );
+        if( ec == std::errc::result_out_of_range )
+            return ParseError{ ParseErrc::out_of_range, 0, sv };
+        if( ec == std::errc() ) // trailing characters
+            return ParseError{ ParseErrc::invalid_character, offset, sv };
+        if( sv.empty() )
+            return ParseError{ ParseErrc::empty, 0, sv };
+        // nothing consumed - the problem is the first character, or the one after a leading '-'
+        return ParseError{ ParseErrc::invalid_character, sv[0] == '-' ? 1u : 0u, sv };
+    }
+
+    auto parse_double( std::string_view sv, double& value ) -> std::errc {
+        char const* last = sv.data() + sv.size();
+        auto [ptr, ec] = std::from_chars( sv.data(), last, value );
+        if( ec == std::errc() && ptr != last )
+            return std::errc::invalid_argument;
+        return ec;
+    }
+
+    auto parse_double( std::string_view sv ) -> std::optional<double> {
+        double d;
+        if( parse_double( sv, d ) == std::errc() )
+            return d;
+        else
+            return {};
+    }
+
+    auto format_double( double value, char* first, char* last ) -> char* {
+        auto [ptr, ec] = std::to_chars( first, last, value ); // no precision given, so shortest round trip
+        return ec == std::errc() ? ptr : nullptr;
+    }
+
+    auto format_double( double value ) -> std::string {
+        char buffer[maxDoubleChars];
+        return std::string( buffer, format_double( value, buffer, buffer + sizeof( buffer ) ) );
+    }
+
+    auto ParseError::message() const -> std::string {
+        auto quoted = "'" + std::string( input ) + "'";
+        switch( code ) {
+            case ParseErrc::out_of_range:
+                return quoted + " is out of range for an integer";
+            default:
+                return quoted + " is not an integer";
+        }
+    }
+}
+
+namespace Cpp17 {
+
+    namespace {
+
+        template<typename ParseToken>
+        void add_token( char const* begin, char const* first, char const* last, ParsedInts& out, ParseToken parseToken ) {
+            int value = 0;
+            auto ec = parseToken( first, last, value );
+            if( ec != std::errc() ) {
+                out.failures.push_back( { out.values.size(), static_cast<std::size_t>( first - begin ), ec } );
+                value = 0;
+            }
+            out.values.push_back( value );
+        }
+
+        auto parse_token_scalar( char const* first, char const* last, int& value ) -> std::errc {
+            return parse_integer( std::string_view( first, static_cast<std::size_t>( last - first ) ), value );
+        }
+
+        // The reference implementation - every other level must match it exactly
+        void parse_ints_scalar( std::string_view buffer, char delimiter, ParsedInts& out ) {
+            char const* const begin = buffer.data();
+            char const* const end = begin + buffer.size();
+            char const* tokenStart = begin;
+            for( char const* p = begin; p != end; ++p ) {
+                if( *p == delimiter ) {
+                    add_token( begin, tokenStart, p, out, parse_token_scalar );
+                    tokenStart = p + 1;
+                }
+            }
+            if( tokenStart != end )
+                add_token( begin, tokenStart, end, out, parse_token_scalar );
+        }
+
+#ifdef GRANDPARENT_X86_SIMD
+        // SWAR (SIMD within a register) - eight ASCII digits in one 64 bit word (little endian)
+        inline auto is_eight_digits( std::uint64_t chunk ) -> bool {
+            return ( ( chunk & 0xF0F0F0F0F0F0F0F0 ) |
+                     ( ( ( chunk + 0x0606060606060606 ) & 0xF0F0F0F0F0F0F0F0 ) >> 4 ) ) == 0x3333333333333333;
+        }
+        inline auto eight_digits_to_int( std::uint64_t chunk ) -> std::uint32_t {
+            chunk -= 0x3030303030303030;
+            chunk = ( chunk * 10 ) + ( chunk >> 8 ); // pairs of digits
+            chunk = ( ( ( chunk & 0x000000FF000000FF ) * ( 100 + ( 1000000ULL << 32 ) ) ) +
+                      ( ( ( chunk >> 16 ) & 0x000000FF000000FF ) * ( 1 + ( 10000ULL << 32 ) ) ) ) >> 32;
+            return static_cast<std::uint32_t>( chunk );
+        }
+
+        // Tokens of up to ten digits are converted eight digits at a time.
+        // Anything unusual (long runs of leading zeros, junk, or too near the end of the buffer
+        // to load a whole word) goes to the scalar parser, so the results stay identical
+        auto parse_token_swar( char const* first, char const* last, char const* bufferEnd, int& value ) -> std::errc {
+            char const* p = first;
+            bool const negative = p != last && *p == '-';
+            p += negative;
+            auto const digits = last - p;
+            if( digits < 1 || digits > 10 || bufferEnd - p < 8 )
+                return parse_token_scalar( first, last, value );
+
+            std::uint64_t chunk;
+            std::memcpy( &chunk, p, sizeof( chunk ) );
+            auto const head = digits < 8 ? digits : 8;
+            if( head < 8 ) {
+                // shift the digits up to the least significant end of the number, padding with '0's
+                chunk <<= 8 * ( 8 - head );
+                chunk |= 0x3030303030303030ULL >> ( 8 * head );
+            }
+            if( !is_eight_digits( chunk ) )
+                return parse_token_scalar( first, last, value );
+
+            std::uint64_t magnitude = eight_digits_to_int( chunk );
+            for( char const* q = p + head; q != last; ++q ) {
+                unsigned const digit = static_cast<unsigned char>( *q ) - static_cast<unsigned char>( '0' );
+                if( digit > 9 )
+                    return parse_token_scalar( first, last, value );
+                magnitude = magnitude * 10 + digit;
+            }
+
+            std::uint64_t const limit = negative
+                ? static_cast<std::uint64_t>( std::numeric_limits<int>::max() ) + 1
+                : static_cast<std::uint64_t>( std::numeric_limits<int>::max() );
+            if( magnitude > limit )
+                return std::errc::result_out_of_range;
+            value = negative
+                ? static_cast<int>( 0 - magnitude )
+                : static_cast<int>( magnitude );
+            return std::errc();
+        }
+
+        // Only the delimiter search differs between levels - one bit per matching byte
+        __attribute__(( target( "sse2" ) ))
+        auto delimiter_mask_sse2( char const* block, char delimiter ) -> std::uint32_t {
+            __m128i bytes = _mm_loadu_si128( reinterpret_cast<__m128i const*>( block ) );
+            return static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( bytes, _mm_set1_epi8( delimiter ) ) ) );
+        }
+        __attribute__(( target( "avx2" ) ))
+        auto delimiter_mask_avx2( char const* block, char delimiter ) -> std::uint32_t {
+            __m256i bytes = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( block ) );
+            return static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( bytes, _mm256_set1_epi8( delimiter ) ) ) );
+        }
+
+        template<std::ptrdiff_t Width, std::uint32_t( *DelimiterMask )( char const*, char )>
+        void parse_ints_simd( std::string_view buffer, char delimiter, ParsedInts& out ) {
+            char const* const begin = buffer.data();
+            char const* const end = begin + buffer.size();
+            auto parseToken = [end]( char const* first, char const* last, int& value ) {
+                return parse_token_swar( first, last, end, value );
+            };
+
+            char const* tokenStart = begin;
+            char const* block = begin;
+            for(; end - block >= Width; block += Width ) {
+                for( std::uint32_t mask = DelimiterMask( block, delimiter ); mask != 0; mask &= mask - 1 ) {
+                    char const* p = block + __builtin_ctz( mask );
+                    add_token( begin, tokenStart, p, out, parseToken );
+                    tokenStart = p + 1;
+                }
+            }
+            for( char const* p = block; p != end; ++p ) {
+                if( *p == delimiter ) {
+                    add_token( begin, tokenStart, p, out, parseToken );
+                    tokenStart = p + 1;
+                }
+            }
+            if( tokenStart != end )
+                add_token( begin, tokenStart, end, out, parseToken );
+        }
+#endif
+    }
+
+    auto detected_simd_level() -> SimdLevel {
+#ifdef GRANDPARENT_X86_SIMD
+        static SimdLevel const level =
+            __builtin_cpu_supports( "avx2" ) ? SimdLevel::AVX2 :
+            __builtin_cpu_supports( "sse2" ) ? SimdLevel::SSE2 :
+            SimdLevel::Scalar;
+        return level;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    void parse_ints( std::string_view buffer, char delimiter, ParsedInts& out ) {
+        parse_ints( buffer, delimiter, out, detected_simd_level() );
+    }
+
+    void parse_ints( std::string_view buffer, char delimiter, ParsedInts& out, SimdLevel level ) {
+        if( level > detected_simd_level() )
+            level = detected_simd_level();
+        switch( level ) {
+#ifdef GRANDPARENT_X86_SIMD
+            case SimdLevel::AVX2:
+                return parse_ints_simd<32, delimiter_mask_avx2>( buffer, delimiter, out );
+            case SimdLevel::SSE2:
+                return parse_ints_simd<16, delimiter_mask_sse2>( buffer, delimiter, out );
+#endif
+            default:
+                return parse_ints_scalar( buffer, delimiter, out );
+        }
+    }
+
+    auto parse_int_column( std::string_view buffer, char delimiter ) -> IntColumn {
+        ParsedInts parsed;
+        parse_ints( buffer, delimiter, parsed );
+        return IntColumn( std::move( parsed ) );
+    }
 }
 
 TEST_CASE( "String to int" ) {
@@ -102,5 +355,635 @@ TEST_CASE( "String to int" ) {
             std::visit( ExpectedIntVisitor{ 7 }, parse_int3( "7" ) );
             std::visit( ExpectedErrorVisitor{ "'Blakes7' is not an integer" }, parse_int3( "Blakes7" ) );
         }
+
+        SECTION( "expected" ) {
+            REQUIRE( parse_int4( "7" ).value() == 7 );
+
+            auto result = parse_int4( "Blakes7" );
+            REQUIRE( result.has_value() == false );
+            REQUIRE( result.error().code == ParseErrc::invalid_character );
+            REQUIRE( result.error().offset == 0 );
+            REQUIRE( result.error().message() == "'Blakes7' is not an integer" ); // only built here
+            REQUIRE_THROWS_AS( result.value(), std::domain_error );
+
+            REQUIRE( parse_int4( "7Blakes" ).error().offset == 1 );
+            REQUIRE( parse_int4( "-x" ).error().offset == 1 );
+            REQUIRE( parse_int4( "" ).error().code == ParseErrc::empty );
+            REQUIRE( parse_int4( "2147483648" ).error().code == ParseErrc::out_of_range );
+        }
+
+        SECTION( "expected - visit" ) {
+
+            struct ExpectedIntVisitor {
+                int expected;
+
+                void operator()( int i ) {
+                    REQUIRE( i == expected );
+                }
+                void operator()( ParseError const& err ) {
+                    FAIL( "Expected " << expected << " but got error: " << err.message() );
+                }
+            };
+            struct ExpectedErrorVisitor {
+
+                std::string expectedMessage;
+
+                void operator()( int i ) {
+                    FAIL( "Expected error but got integer, " << i );
+                }
+                void operator()( ParseError const& err ) {
+                    REQUIRE( err.message() == expectedMessage );
+                }
+            };
+
+            // found by ADL - reads just like std::visit
+            visit( ExpectedIntVisitor{ 7 }, parse_int4( "7" ) );
+            visit( ExpectedErrorVisitor{ "'Blakes7' is not an integer" }, parse_int4( "Blakes7" ) );
+        }
     }
 }
+
+TEST_CASE( "parse_integer engine" ) {
+
+    using namespace Cpp17;
+
+    SECTION( "every width and signedness" ) {
+        std::int8_t i8 = 0;
+        REQUIRE( parse_integer( "-128", i8 ) == std::errc() );
+        REQUIRE( i8 == -128 );
+        REQUIRE( parse_integer( "128", i8 ) == std::errc::result_out_of_range );
+
+        std::uint8_t u8 = 0;
+        REQUIRE( parse_integer( "255", u8 ) == std::errc() );
+        REQUIRE( u8 == 255 );
+        REQUIRE( parse_integer( "256", u8 ) == std::errc::result_out_of_range );
+        REQUIRE( parse_integer( "-1", u8 ) == std::errc::invalid_argument );
+
+        std::int64_t i64 = 0;
+        REQUIRE( parse_integer( "-9223372036854775808", i64 ) == std::errc() );
+        REQUIRE( i64 == std::numeric_limits<std::int64_t>::min() );
+        REQUIRE( parse_integer( "9223372036854775808", i64 ) == std::errc::result_out_of_range );
+
+        std::uint64_t u64 = 0;
+        REQUIRE( parse_integer( "18446744073709551615", u64 ) == std::errc() );
+        REQUIRE( u64 == std::numeric_limits<std::uint64_t>::max() );
+        REQUIRE( parse_integer( "18446744073709551616", u64 ) == std::errc::result_out_of_range );
+    }
+
+    SECTION( "from_chars semantics" ) {
+        int i = 42;
+        REQUIRE( parse_integer( "", i ) == std::errc::invalid_argument );
+        REQUIRE( parse_integer( "-", i ) == std::errc::invalid_argument );
+        REQUIRE( parse_integer( "+7", i ) == std::errc::invalid_argument );
+        REQUIRE( parse_integer( " 7", i ) == std::errc::invalid_argument );
+        REQUIRE( i == 42 ); // untouched on failure
+
+        REQUIRE( parse_integer( "007", i ) == std::errc() );
+        REQUIRE( i == 7 );
+
+        // Same answers, and same end pointer, as the standard library
+        for( std::string_view sv : { "0", "-0", "123abc", "-2147483648", "2147483648", "99999999999999999999x", "x1" } ) {
+            int ours = 0, theirs = 0;
+            auto a = parse_integer( sv.data(), sv.data() + sv.size(), ours );
+            auto b = std::from_chars( sv.data(), sv.data() + sv.size(), theirs );
+            CHECK( a.ec == b.ec );
+            CHECK( a.ptr == b.ptr );
+            CHECK( ours == theirs );
+        }
+    }
+
+    SECTION( "trailing garbage is an error" ) {
+        REQUIRE( Cpp17::parse_int2( "7 " ).has_value() == false );
+        REQUIRE( Cpp17::parse_int2( "7Blakes" ).has_value() == false );
+        REQUIRE( Cpp17::parse_int2( "-2147483648" ) == std::numeric_limits<int>::min() );
+        REQUIRE( Cpp17::parse_int2( "2147483648" ).has_value() == false );
+    }
+}
+
+TEST_CASE( "Batch parsing delimited ints" ) {
+
+    using namespace Cpp17;
+
+    std::vector<SimdLevel> levels = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 };
+
+    SECTION( "values and failures" ) {
+        for( auto level : levels ) {
+            ParsedInts result;
+            parse_ints( "1,1,2,-3,Blakes7,,2147483648,8,", ',', result, level );
+
+            REQUIRE( result.values == std::vector<int>{ 1, 1, 2, -3, 0, 0, 0, 8 } );
+            REQUIRE( result.failures.size() == 3 );
+            CHECK( result.failures[0].index == 4 );
+            CHECK( result.failures[0].offset == 9 );
+            CHECK( result.failures[0].ec == std::errc::invalid_argument );
+            CHECK( result.failures[1].index == 5 );
+            CHECK( result.failures[1].ec == std::errc::invalid_argument );
+            CHECK( result.failures[2].index == 6 );
+            CHECK( result.failures[2].offset == 18 );
+            CHECK( result.failures[2].ec == std::errc::result_out_of_range );
+        }
+    }
+
+    SECTION( "every level matches the scalar parser" ) {
+        // Random mix of good and bad tokens, long enough to cover whole blocks and the tail
+        std::string tokens[] = { "0", "7", "-7", "12345678", "-12345678", "123456789", "2147483647", "-2147483648",
+                                 "2147483648", "-2147483649", "99999999999", "0000000000042", "1x", "x1", "-", "", " 5", "+5" };
+        std::uint32_t seed = 12345;
+        std::string buffer;
+        for( int i = 0; i < 5000; ++i ) {
+            seed = seed * 1664525 + 1013904223;
+            buffer += tokens[ ( seed >> 16 ) % std::size( tokens ) ];
+            buffer += '\n';
+        }
+
+        for( std::size_t length : { buffer.size(), buffer.size() - 1, buffer.size() - 7, std::size_t( 40 ), std::size_t( 3 ) } ) {
+            std::string_view sv( buffer.data(), length );
+            ParsedInts expected;
+            parse_ints( sv, '\n', expected, SimdLevel::Scalar );
+
+            for( auto level : levels ) {
+                ParsedInts result;
+                parse_ints( sv, '\n', result, level );
+                REQUIRE( result.values == expected.values );
+                REQUIRE( result.failures.size() == expected.failures.size() );
+                for( std::size_t i = 0; i < result.failures.size(); ++i ) {
+                    CHECK( result.failures[i].index == expected.failures[i].index );
+                    CHECK( result.failures[i].offset == expected.failures[i].offset );
+                    CHECK( result.failures[i].ec == expected.failures[i].ec );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE( "Error channel cost", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    // A run of short inputs, so each benchmark measures the per-call cost rather than one lucky call
+    std::vector<std::string> good, bad;
+    for( int i = 0; i < 1000; ++i ) {
+        good.push_back( std::to_string( i * 7919 ) );
+        bad.push_back( "Blakes" + std::to_string( i ) );
+    }
+
+    BENCHMARK( "variant<int, domain_error> - success" ) {
+        int total = 0;
+        for( auto const& s : good )
+            total += std::get<int>( parse_int3( s ) );
+        return total;
+    };
+    BENCHMARK( "variant<int, domain_error> - failure" ) {
+        std::size_t failures = 0;
+        for( auto const& s : bad )
+            failures += parse_int3( s ).index();
+        return failures;
+    };
+    BENCHMARK( "Expected<int, ParseError> - success" ) {
+        int total = 0;
+        for( auto const& s : good )
+            total += *parse_int4( s );
+        return total;
+    };
+    BENCHMARK( "Expected<int, ParseError> - failure" ) {
+        std::size_t failures = 0;
+        for( auto const& s : bad )
+            failures += !parse_int4( s ).has_value();
+        return failures;
+    };
+}
+
+TEST_CASE( "Streaming ints in chunks" ) {
+
+    using namespace Cpp17;
+
+    SECTION( "a number split across chunks" ) {
+        std::vector<int> values;
+        StreamingIntParser parser( ',' );
+        auto collect = [&]( StreamedInt result ) { values.push_back( result.value ); };
+
+        parser.feed( "1,1,2,-", collect );
+        REQUIRE( values == std::vector<int>{ 1, 1, 2 } );
+        parser.feed( "3", collect );
+        parser.feed( "5,", collect );
+        REQUIRE( values == std::vector<int>{ 1, 1, 2, -35 } );
+        parser.feed( "8", collect );
+        parser.finish( collect );
+        REQUIRE( values == std::vector<int>{ 1, 1, 2, -35, 8 } );
+    }
+
+    SECTION( "same results as parsing it all at once, however it's chopped up" ) {
+        std::string tokens[] = { "0", "7", "-7", "12345678", "-2147483648", "2147483647", "2147483648", "-2147483649",
+                                 "99999999999", "99999999999x", "0000000000000000000042", "-00000000000000000000", "9999999999x",
+                                 "1x", "x1", "-", "--1", "", " 5" };
+        std::uint32_t seed = 42;
+        auto next = [&] { seed = seed * 1664525 + 1013904223; return seed >> 16; };
+        std::string input;
+        for( int i = 0; i < 2000; ++i ) {
+            input += tokens[ next() % std::size( tokens ) ];
+            input += '\n';
+        }
+        input += "12"; // last one has no delimiter
+
+        ParsedInts expected;
+        parse_ints( input, '\n', expected );
+
+        for( std::size_t maxChunk : { 1, 2, 3, 7, 64, 4096 } ) {
+            std::vector<StreamedInt> results;
+            auto collect = [&]( StreamedInt result ) { results.push_back( result ); };
+
+            StreamingIntParser parser;
+            for( std::size_t pos = 0; pos < input.size(); ) {
+                auto size = std::min( input.size() - pos, std::size_t( 1 + next() % maxChunk ) );
+                parser.feed( std::string_view( input ).substr( pos, size ), collect );
+                pos += size;
+            }
+            parser.finish( collect );
+
+            REQUIRE( results.size() == expected.values.size() );
+            std::size_t failure = 0;
+            for( std::size_t i = 0; i < results.size(); ++i ) {
+                REQUIRE( results[i].value == expected.values[i] );
+                if( results[i].ec != std::errc() ) {
+                    REQUIRE( failure < expected.failures.size() );
+                    REQUIRE( expected.failures[failure].index == i );
+                    REQUIRE( expected.failures[failure].ec == results[i].ec );
+                    REQUIRE( expected.failures[failure].offset == results[i].offset );
+                    ++failure;
+                }
+            }
+            REQUIRE( failure == expected.failures.size() );
+        }
+    }
+}
+
+TEST_CASE( "Columnar parse results" ) {
+
+    using namespace Cpp17;
+
+    std::vector<std::string> strings = { "1", "1", "Blakes7", "2", "", "3", "5", "-8" };
+
+    SECTION( "from a range of strings" ) {
+        auto column = parse_int_column( strings );
+
+        REQUIRE( column.size() == 8 );
+        REQUIRE( column.null_count() == 2 );
+        REQUIRE( column.validity() == std::vector<std::uint64_t>{ 0b11101011 } );
+        REQUIRE( column.get( 3 ) == 2 );
+        REQUIRE( column.get( 2 ).has_value() == false );
+
+        // nulls hold 0, so aggregating doesn't need to look at the bitmap
+        REQUIRE( std::accumulate( column.values().begin(), column.values().end(), 0 ) == 4 );
+
+        std::vector<std::size_t> indices;
+        column.for_each_valid( [&]( std::size_t i, int value ) {
+            REQUIRE( column.get( i ) == value );
+            indices.push_back( i );
+        } );
+        REQUIRE( indices == std::vector<std::size_t>{ 0, 1, 3, 5, 6, 7 } );
+    }
+
+    SECTION( "same as parse_int2 over each value, across several bitmap words" ) {
+        std::vector<std::string> many;
+        std::string buffer;
+        for( int i = 0; i < 1000; ++i ) {
+            many.push_back( i % 3 == 0 ? "x" + std::to_string( i ) : std::to_string( i ) );
+            buffer += many.back() + ",";
+        }
+
+        for( auto const& column : { parse_int_column( many ), parse_int_column( buffer, ',' ) } ) {
+            REQUIRE( column.size() == many.size() );
+            REQUIRE( column.validity().size() == 16 );
+            REQUIRE( column.null_count() == 334 );
+            for( std::size_t i = 0; i < many.size(); ++i )
+                REQUIRE( column.get( i ) == parse_int2( many[i] ) );
+        }
+    }
+}
+
+TEST_CASE( "Columnar vs vector of optionals", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    std::vector<std::string> strings;
+    for( int i = 0; i < 100000; ++i )
+        strings.push_back( i % 10 == 0 ? "n/a" : std::to_string( i ) );
+
+    auto optionals = std::vector<std::optional<int>>();
+    for( auto const& s : strings )
+        optionals.push_back( parse_int2( s ) );
+    auto column = parse_int_column( strings );
+
+    BENCHMARK( "parse - vector<optional<int>>" ) {
+        std::vector<std::optional<int>> result;
+        result.reserve( strings.size() );
+        for( auto const& s : strings )
+            result.push_back( parse_int2( s ) );
+        return result.size();
+    };
+    BENCHMARK( "parse - IntColumn" ) {
+        return parse_int_column( strings ).size();
+    };
+
+    BENCHMARK( "sum - vector<optional<int>>" ) {
+        long long total = 0;
+        for( auto const& value : optionals )
+            if( value )
+                total += *value;
+        return total;
+    };
+    BENCHMARK( "sum - IntColumn" ) {
+        return std::accumulate( column.values().begin(), column.values().end(), 0LL );
+    };
+
+    BENCHMARK( "count nulls - vector<optional<int>>" ) {
+        return std::count( optionals.begin(), optionals.end(), std::nullopt );
+    };
+    BENCHMARK( "count nulls - IntColumn" ) {
+        return column.null_count();
+    };
+}
+
+TEST_CASE( "Doubles" ) {
+
+    using namespace Cpp17;
+
+    SECTION( "parse" ) {
+        REQUIRE( parse_double( "3.14" ) == 3.14 );
+        REQUIRE( parse_double( "-1e-7" ) == -1e-7 );
+        REQUIRE( parse_double( "0.1" ) == 0.1 );
+        REQUIRE( parse_double( "Blakes7" ).has_value() == false );
+        REQUIRE( parse_double( "7.0Blakes" ).has_value() == false );
+        REQUIRE( parse_double( "" ).has_value() == false );
+
+        double d;
+        REQUIRE( parse_double( "1e400", d ) == std::errc::result_out_of_range );
+
+        // Correctly rounded, right on the halfway point between two doubles
+        REQUIRE( parse_double( "9007199254740993" ) == 9007199254740992.0 );
+        REQUIRE( parse_double( "2.2250738585072011e-308" ) == 2.2250738585072011e-308 );
+    }
+
+    SECTION( "format is shortest round trip" ) {
+        REQUIRE( format_double( 0.1 ) == "0.1" );
+        REQUIRE( format_double( 0.1 + 0.2 ) == "0.30000000000000004" );
+        REQUIRE( format_double( 100.0 ) == "100" );
+        REQUIRE( format_double( 1e23 ) == "1e+23" );
+        REQUIRE( format_double( -0.0 ) == "-0" );
+        REQUIRE( format_double( 5e-324 ) == "5e-324" );
+        REQUIRE( format_double( -std::numeric_limits<double>::min() ).size() <= maxDoubleChars );
+
+        char small[4];
+        REQUIRE( format_double( 0.25, small, small + sizeof( small ) ) == small + 4 );
+        REQUIRE( format_double( 0.125, small, small + sizeof( small ) ) == nullptr );
+    }
+
+    SECTION( "round trip" ) {
+        // Random bit patterns cover every exponent, plus the awkward edges
+        std::vector<double> values = {
+            0.0, -0.0, 1.0, std::numeric_limits<double>::min(), std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::lowest(),
+            std::numeric_limits<double>::epsilon(), std::numeric_limits<double>::infinity() };
+        std::uint64_t seed = 0x9E3779B97F4A7C15;
+        while( values.size() < 100000 ) {
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+            double d;
+            std::memcpy( &d, &seed, sizeof( d ) );
+            if( d == d ) // skip NaNs - they never compare equal
+                values.push_back( d );
+        }
+
+        for( double d : values ) {
+            auto text = format_double( d );
+            double back;
+            if( parse_double( text, back ) != std::errc() || std::memcmp( &back, &d, sizeof( d ) ) != 0 )
+                FAIL( text << " didn't read back to the same double" );
+        }
+    }
+}
+
+TEST_CASE( "Double conversions", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    std::vector<std::string> prices;
+    std::vector<double> values;
+    for( int i = 0; i < 1000; ++i ) {
+        values.push_back( i * 1.37 + i / 7.0 );
+        prices.push_back( format_double( values.back() ) );
+    }
+
+    BENCHMARK( "parse - stringstream" ) {
+        double total = 0;
+        for( auto const& s : prices ) {
+            std::stringstream ss( s );
+            double d;
+            ss >> d;
+            total += d;
+        }
+        return total;
+    };
+    BENCHMARK( "parse - std::stod" ) {
+        double total = 0;
+        for( auto const& s : prices )
+            total += std::stod( s );
+        return total;
+    };
+    BENCHMARK( "parse - parse_double" ) {
+        double total = 0;
+        for( auto const& s : prices )
+            total += *parse_double( s );
+        return total;
+    };
+
+    BENCHMARK( "format - stringstream (precision 17)" ) {
+        std::size_t size = 0;
+        for( double d : values ) {
+            std::stringstream ss;
+            ss.precision( 17 );
+            ss << d;
+            size += ss.str().size();
+        }
+        return size;
+    };
+    BENCHMARK( "format - format_double" ) {
+        std::size_t size = 0;
+        char buffer[maxDoubleChars];
+        for( double d : values )
+            size += static_cast<std::size_t>( format_double( d, buffer, buffer + sizeof( buffer ) ) - buffer );
+        return size;
+    };
+}
+
+TEST_CASE( "Compile time parsing" ) {
+
+    using namespace Cpp17;
+    using namespace Cpp17::literals;
+
+    // Same implementation as at runtime - checked by the compiler
+    static_assert( *parse_integer<int>( "42" ) == 42 );
+    static_assert( *parse_integer<int>( "-2147483648" ) == std::numeric_limits<int>::min() );
+    static_assert( !parse_integer<int>( "2147483648" ) );
+    static_assert( !parse_integer<int>( "Blakes7" ) );
+    static_assert( *parse_integer<std::uint64_t>( "18446744073709551615" ) == std::numeric_limits<std::uint64_t>::max() );
+
+    constexpr int maxConnections = "128"_int;
+    static_assert( maxConnections == 128 );
+    // constexpr int badConnections = "12B"_int; // compile error
+
+    constexpr int answer = 42_int;
+    static_assert( answer == 42 );
+    static_assert( -2147483647_int == -2147483647 );
+    // constexpr int tooBig = 2147483648_int; // static_assert fails
+
+    SECTION( "runtime" ) {
+        std::string fromConfig = "Blakes7";
+        REQUIRE( parse_integer<int>( "7" ) == parse_int2( "7" ) );
+        REQUIRE( parse_integer<int>( fromConfig ) == parse_int2( fromConfig ) );
+        REQUIRE_THROWS_AS( checked_parse_integer<int>( fromConfig ), std::domain_error );
+    }
+}
+
+TEST_CASE( "Other bases" ) {
+
+    using namespace Cpp17;
+
+    SECTION( "prefixes and signs" ) {
+        REQUIRE( parse_int2( "1F", 16 ) == 31 );
+        REQUIRE( parse_int2( "0x1f", 16 ) == 31 );
+        REQUIRE( parse_int2( "-0X1F", 16 ) == -31 );
+        REQUIRE( parse_int2( "0b101", 2 ) == 5 );
+        REQUIRE( parse_int2( "777", 8 ) == 511 );
+        REQUIRE( parse_int2( "0b1", 16 ) == 0xB1 ); // b is a hex digit, not a prefix
+        REQUIRE( parse_int2( "0x", 16 ).has_value() == false );
+        REQUIRE( parse_int2( "0x1G", 16 ).has_value() == false );
+        REQUIRE( parse_int2( "102", 2 ).has_value() == false );
+        REQUIRE( parse_int2( "z", 36 ) == 35 );
+
+        int i = 0;
+        REQUIRE( parse_int1( "ff", i, 16 ) == true );
+        REQUIRE( i == 255 );
+        REQUIRE( std::get<std::domain_error>( parse_int3( "0xBlakes7", 16 ) ).what() == std::string( "'0xBlakes7' is not a base 16 integer" ) );
+    }
+
+    SECTION( "bases outside 2 to 36 are errors" ) {
+        for( int base : { 0, 1, -1, -16, 37, 100, std::numeric_limits<int>::min() } ) {
+            int i = 42;
+            CHECK_FALSE( parse_int1( "1", i, base ) );
+            CHECK( i == 42 );
+            CHECK_FALSE( parse_int2( "1", base ) );
+            CHECK( std::holds_alternative<std::domain_error>( parse_int3( "1", base ) ) );
+            CHECK( parse_integer( "1", i, base ) == std::errc::invalid_argument );
+            CHECK_FALSE( parse_integer<unsigned>( "1", base ) );
+        }
+        REQUIRE( std::get<std::domain_error>( parse_int3( "1", 0 ) ).what() == std::string( "base 0 is not supported (must be 2 to 36)" ) );
+    }
+
+    SECTION( "overflow is exact" ) {
+        REQUIRE( parse_int2( "0x7FFFFFFF", 16 ) == std::numeric_limits<int>::max() );
+        REQUIRE( parse_int2( "-0x80000000", 16 ) == std::numeric_limits<int>::min() );
+        REQUIRE( parse_int2( "0x80000000", 16 ).has_value() == false );
+        REQUIRE( parse_int2( "0x0000000000000000000000001", 16 ) == 1 );
+
+        std::uint64_t u64 = 0;
+        REQUIRE( parse_integer( "FFFFFFFFFFFFFFFF", u64, 16 ) == std::errc() );
+        REQUIRE( u64 == std::numeric_limits<std::uint64_t>::max() );
+        REQUIRE( parse_integer( "10000000000000000", u64, 16 ) == std::errc::result_out_of_range );
+        REQUIRE( parse_integer( std::string( 64, '1' ), u64, 2 ) == std::errc() );
+        REQUIRE( parse_integer( "1" + std::string( 64, '0' ), u64, 2 ) == std::errc::result_out_of_range );
+
+        std::uint8_t u8 = 0;
+        REQUIRE( parse_integer( "000000000000FF", u8, 16 ) == std::errc() );
+        REQUIRE( u8 == 255 );
+        REQUIRE( parse_integer( "00000000000100", u8, 16 ) == std::errc::result_out_of_range );
+    }
+
+    SECTION( "control characters aren't digits" ) {
+        std::uint32_t u32 = 0;
+        std::string_view const sv = "1234567\x10";
+        auto [ptr, ec] = parse_integer( sv.data(), sv.data() + sv.size(), u32, 16 );
+        REQUIRE( ec == std::errc() );
+        REQUIRE( u32 == 0x1234567 );
+        REQUIRE( ptr == sv.data() + 7 );
+    }
+
+    SECTION( "same answers as std::from_chars" ) {
+        std::uint64_t seed = 0x2545F4914F6CDD1D;
+        auto next = [&] { seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17; return seed; };
+        // including control characters (0x10-0x19 are 0-9 with the 0x20 bit clear) and non-ASCII bytes
+        char const alphabet[] = "0123456789abcdefABCDEFxz-\x01\x10\x19\x1f\x7f\x80\x90\xb0\xff";
+
+        auto check = [&]( auto type, int base, std::string const& s ) {
+            decltype( type ) ours = 0, theirs = 0;
+            auto a = parse_integer( s.data(), s.data() + s.size(), ours, base );
+            auto b = std::from_chars( s.data(), s.data() + s.size(), theirs, base );
+            if( a.ec != b.ec || a.ptr != b.ptr || ours != theirs )
+                FAIL( "Mismatch for '" << s << "' in base " << base );
+        };
+
+        for( int i = 0; i < 20000; ++i ) {
+            int base = std::array<int, 4>{ 2, 8, 16, 10 }[ next() % 4 ];
+            std::string s;
+            if( next() % 2 ) {
+                // mostly valid digits, with the odd stray character
+                auto length = next() % 70;
+                for( std::uint64_t n = 0; n < length; ++n )
+                    s += next() % 50 == 0 ? alphabet[ next() % ( sizeof( alphabet ) - 1 ) ] : alphabet[ next() % base ];
+            }
+            else {
+                char buffer[70];
+                s.assign( buffer, std::to_chars( buffer, buffer + sizeof( buffer ), static_cast<std::int64_t>( next() ) >> ( next() % 64 ), base ).ptr );
+            }
+            check( int(), base, s );
+            check( std::int64_t(), base, s );
+            check( std::uint64_t(), base, s );
+            check( std::uint16_t(), base, s );
+        }
+    }
+
+    SECTION( "compile time" ) {
+        // SWAR is just shifts and masks, so this works at compile time too
+        static_assert( *parse_integer<std::uint32_t>( "DEADBEEF", 16 ) == 0xDEADBEEF );
+        static_assert( *parse_integer<std::uint64_t>( "0123456701234567", 8 ) == 0123456701234567 ); // octal literal
+        static_assert( *parse_integer<std::uint8_t>( "10100101", 2 ) == 0xA5 );
+        static_assert( !parse_integer<std::int32_t>( "80000000", 16 ) );
+    }
+}
+
+TEST_CASE( "Hex parsing", "[!benchmark]" ) {
+
+    using namespace Cpp17;
+
+    std::vector<std::string> ids;
+    std::uint64_t seed = 88172645463325252;
+    for( int i = 0; i < 1000; ++i ) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        char buffer[16];
+        ids.emplace_back( buffer, std::to_chars( buffer, buffer + sizeof( buffer ), seed, 16 ).ptr );
+    }
+
+    BENCHMARK( "std::stoul( s, nullptr, 16 )" ) {
+        std::uint64_t total = 0;
+        for( auto const& s : ids )
+            total += std::stoul( s, nullptr, 16 );
+        return total;
+    };
+    BENCHMARK( "std::from_chars( ..., 16 )" ) {
+        std::uint64_t total = 0;
+        for( auto const& s : ids ) {
+            std::uint64_t value = 0;
+            std::from_chars( s.data(), s.data() + s.size(), value, 16 );
+            total += value;
+        }
+        return total;
+    };
+    BENCHMARK( "parse_integer( ..., 16 )" ) {
+        std::uint64_t total = 0;
+        for( auto const& s : ids ) {
+            std::uint64_t value = 0;
+            parse_integer( s, value, 16 );
+            total += value;
+        }
+        return total;
+    };
+}
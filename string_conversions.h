@@ -0,0 +1,553 @@
+#pragma once
+
+#include "simd_level.h"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Cpp17 {
+
+    namespace detail {
+
+        // SWAR (SIMD within a register) for power of two bases: eight digits of bitsPerDigit bits each,
+        // loaded little endian, so the first (most significant) digit is in the lowest byte.
+        // Written as plain shifts and masks so it also works at compile time - compilers turn the load into one mov
+        constexpr auto load8( char const* p ) -> std::uint64_t {
+            return static_cast<std::uint64_t>( static_cast<unsigned char>( p[0] ) ) |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[1] ) ) << 8 |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[2] ) ) << 16 |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[3] ) ) << 24 |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[4] ) ) << 32 |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[5] ) ) << 40 |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[6] ) ) << 48 |
+                   static_cast<std::uint64_t>( static_cast<unsigned char>( p[7] ) ) << 56;
+        }
+
+        // Digit values (one per byte) if all eight chars are valid digits of base 2, 8 or 16 - otherwise nullopt
+        constexpr auto swar_digits( std::uint64_t chunk, unsigned base ) -> std::optional<std::uint64_t> {
+            constexpr std::uint64_t ones = 0x0101010101010101;
+            if( base == 2 ) {
+                if( ( chunk & ( ones * 0xFE ) ) != ones * '0' )
+                    return {};
+                return chunk & ones;
+            }
+            if( base == 8 ) {
+                if( ( chunk & ( ones * 0xF8 ) ) != ones * '0' )
+                    return {};
+                return chunk & ( ones * 0x07 );
+            }
+            // base 16: every byte must be 0-9, or a-f once lower cased (lower casing would also turn 0x10-0x19
+            // into 0-9, so digits are checked as they are).
+            // Adding ( 0x80 - lo ) sets a byte's top bit if it's >= lo - no carries, as long as every byte is ASCII
+            if( ( chunk & ( ones * 0x80 ) ) != 0 )
+                return {};
+            std::uint64_t const lower = chunk | ( ones * 0x20 );
+            auto inRange = []( std::uint64_t bytes, unsigned lo, unsigned hi ) {
+                return ( bytes + ones * ( 0x80 - lo ) ) & ~( bytes + ones * ( 0x7F - hi ) ) & ( ones * 0x80 );
+            };
+            std::uint64_t const isDigit = inRange( chunk, '0', '9' );
+            std::uint64_t const isLetter = inRange( lower, 'a', 'f' );
+            if( ( isDigit | isLetter ) != ones * 0x80 )
+                return {};
+            return ( lower & ( ones * 0x0F ) ) + ( isLetter >> 7 ) * 9;
+        }
+
+        // Packs the eight digit values together, first digit most significant
+        constexpr auto swar_combine( std::uint64_t digits, unsigned bitsPerDigit ) -> std::uint64_t {
+            digits = ( ( digits << bitsPerDigit ) | ( digits >> 8 ) ) & 0x00FF00FF00FF00FF;
+            digits = ( ( digits << ( 2 * bitsPerDigit ) ) | ( digits >> 16 ) ) & 0x0000FFFF0000FFFF;
+            digits = ( ( digits << ( 4 * bitsPerDigit ) ) | ( digits >> 32 ) ) & 0x00000000FFFFFFFF;
+            return digits;
+        }
+
+        template<typename T>
+        constexpr auto parse_integer( char const* first, char const* last, T& value, unsigned base, bool allowPrefix ) -> std::from_chars_result {
+            static_assert( std::is_integral_v<T> && !std::is_same_v<T, bool>, "parse_integer needs an integer type" );
+            using U = std::make_unsigned_t<T>;
+
+            if( base < 2 || base > 36 )
+                return { first, std::errc::invalid_argument };
+
+            char const* it = first;
+            bool negative = false;
+            if constexpr( std::is_signed_v<T> ) {
+                if( it != last && *it == '-' ) {
+                    negative = true;
+                    ++it;
+                }
+            }
+            if( allowPrefix && last - it >= 2 && it[0] == '0' ) {
+                char const x = static_cast<char>( it[1] | 0x20 );
+                if( ( base == 16 && x == 'x' ) || ( base == 2 && x == 'b' ) )
+                    it += 2;
+            }
+
+            // Largest magnitude we can represent - one more for negative numbers of signed types
+            U const limit = negative
+                ? static_cast<U>( static_cast<U>( std::numeric_limits<T>::max() ) + 1 )
+                : static_cast<U>( std::numeric_limits<T>::max() );
+            U const cutoff = static_cast<U>( limit / base );
+            unsigned const cutlim = static_cast<unsigned>( limit % base );
+
+            char const* digitsStart = it;
+            U magnitude = 0;
+            bool overflow = false;
+
+            // Eight digits at a time for bases 2, 8 and 16
+            if( base == 2 || base == 8 || base == 16 ) {
+                unsigned const bitsPerDigit = base == 2 ? 1 : base == 8 ? 3 : 4;
+                unsigned const chunkBits = 8 * bitsPerDigit;
+                constexpr unsigned maxBits = std::numeric_limits<U>::digits;
+                for(; last - it >= 8; it += 8 ) {
+                    auto digits = swar_digits( load8( it ), base );
+                    if( !digits )
+                        break; // the scalar loop below finds exactly where they stop
+                    if( overflow )
+                        continue;
+                    std::uint64_t const chunkValue = swar_combine( *digits, bitsPerDigit );
+                    if( magnitude == 0 ) {
+                        if( chunkBits > maxBits && ( chunkValue >> ( chunkBits > maxBits ? maxBits : 0 ) ) != 0 )
+                            overflow = true;
+                        else
+                            magnitude = static_cast<U>( chunkValue );
+                    }
+                    else if( chunkBits >= maxBits || ( magnitude >> ( chunkBits >= maxBits ? 0 : maxBits - chunkBits ) ) != 0 )
+                        overflow = true;
+                    else
+                        magnitude = static_cast<U>( ( magnitude << ( chunkBits >= maxBits ? 0 : chunkBits ) ) | chunkValue );
+                }
+                if( magnitude > limit )
+                    overflow = true;
+            }
+
+            for(; it != last; ++it ) {
+                unsigned char const c = static_cast<unsigned char>( *it );
+                unsigned digit = c - static_cast<unsigned char>( '0' );
+                if( digit > 9 ) {
+                    if( base <= 10 )
+                        break;
+                    digit = static_cast<unsigned char>( c | 0x20 ) - static_cast<unsigned char>( 'a' );
+                    digit = digit < 26 ? digit + 10 : base;
+                }
+                if( digit >= base )
+                    break;
+                if( overflow )
+                    continue; // keep going so ptr ends up after the digits
+                if( magnitude > cutoff || ( magnitude == cutoff && digit > cutlim ) )
+                    overflow = true;
+                else
+                    magnitude = static_cast<U>( magnitude * base + digit );
+            }
+
+            if( it == digitsStart )
+                return { first, std::errc::invalid_argument };
+            if( overflow )
+                return { it, std::errc::result_out_of_range };
+
+            if constexpr( std::is_signed_v<T> )
+                value = negative
+                    ? static_cast<T>( 0 - magnitude ) // well defined modular arithmetic, then narrowed back
+                    : static_cast<T>( magnitude );
+            else
+                value = magnitude;
+            return { it, std::errc() };
+        }
+
+        template<typename T>
+        constexpr auto parse_whole( std::string_view sv, T& value, unsigned base, bool allowPrefix ) -> std::errc {
+            char const* last = sv.data() + sv.size();
+            auto [ptr, ec] = detail::parse_integer( sv.data(), last, value, base, allowPrefix );
+            if( ec == std::errc() && ptr != last )
+                return std::errc::invalid_argument;
+            return ec;
+        }
+    }
+
+    // The parsing engine behind parse_int1/2/3
+    // - same rules as std::from_chars (base 2 to 36, optional '-' for signed types only, no whitespace, no '+', no prefix)
+    // - any other base is invalid_argument (from_chars leaves that undefined)
+    // - no allocation, no locale, no exceptions
+    // - ptr points one past the last digit consumed - even on overflow, just like from_chars
+    template<typename T>
+    constexpr auto parse_integer( char const* first, char const* last, T& value, int base = 10 ) -> std::from_chars_result {
+        return detail::parse_integer( first, last, value, static_cast<unsigned>( base ), false );
+    }
+
+    // Whole string must be an integer - trailing characters are an error
+    template<typename T>
+    constexpr auto parse_integer( std::string_view sv, T& value, int base = 10 ) -> std::errc {
+        return detail::parse_whole( sv, value, static_cast<unsigned>( base ), false );
+    }
+
+    // As above, but also allowing a 0x prefix for base 16, or 0b for base 2 (after any '-')
+    template<typename T>
+    constexpr auto parse_integer_with_prefix( std::string_view sv, T& value, int base ) -> std::errc {
+        return detail::parse_whole( sv, value, static_cast<unsigned>( base ), true );
+    }
+
+    // Same again, returning optional - usable at compile time, e.g. static_assert( *parse_integer<int>( "42" ) == 42 )
+    template<typename T>
+    constexpr auto parse_integer( std::string_view sv, int base = 10 ) -> std::optional<T> {
+        T value{};
+        if( parse_integer( sv, value, base ) == std::errc() )
+            return value;
+        return {};
+    }
+
+    // Throws if it's not a valid T - which, in a constant expression, is a compile error
+    template<typename T>
+    constexpr auto checked_parse_integer( std::string_view sv ) -> T {
+        T value{};
+        if( parse_integer( sv, value ) != std::errc() )
+            throw std::domain_error( "'" + std::string( sv ) + "' is not a valid integer constant" );
+        return value;
+    }
+
+    namespace detail {
+        // static storage, so its address can be used in a constant expression
+        template<char... Chars>
+        inline constexpr char literalChars[] = { Chars... };
+    }
+
+    // Checked integer literals for constants, so bad ones break the build rather than costing startup time
+    namespace literals {
+
+        // 42_int - a malformed or out of range literal fails the static_assert
+        template<char... Chars>
+        constexpr auto operator""_int() -> int {
+            constexpr auto result = parse_integer<int>( std::string_view( detail::literalChars<Chars...>, sizeof...( Chars ) ) );
+            static_assert( result.has_value(), "not a valid int literal" );
+            return *result;
+        }
+
+        // "42"_int - for strings in generated headers. Use it to initialise a constexpr variable,
+        // then a malformed or out of range string is a compile error (at runtime it would throw)
+        constexpr auto operator""_int( char const* str, std::size_t size ) -> int {
+            return checked_parse_integer<int>( std::string_view( str, size ) );
+        }
+    }
+
+    // A cheap error channel for parse_int4
+    // - just a code, an offset and a view of the input. The message is only built if someone asks for it
+
+    enum class ParseErrc : unsigned char { empty = 1, invalid_character, out_of_range };
+
+    struct ParseError {
+        ParseErrc code;
+        std::uint32_t offset;   // of the offending character (or of the number, if it's out of range)
+        std::string_view input; // not owned - must still be alive when you call message()
+
+        auto message() const -> std::string;
+    };
+
+    // Either a value or an error, like std::expected (C++23) - but still visitable, like std::variant
+    template<typename T, typename E>
+    class Expected {
+        std::variant<T, E> m_storage;
+    public:
+        Expected( T value ) : m_storage( std::in_place_index<0>, std::move( value ) ) {}
+        Expected( E error ) : m_storage( std::in_place_index<1>, std::move( error ) ) {}
+
+        auto has_value() const noexcept -> bool { return m_storage.index() == 0; }
+        explicit operator bool() const noexcept { return has_value(); }
+
+        // Checked - throws if there's no value (building the message only now)
+        auto value() const -> T const& {
+            if( !has_value() )
+                throw std::domain_error( error().message() );
+            return *std::get_if<0>( &m_storage );
+        }
+        // Unchecked
+        auto operator*() const noexcept -> T const& { return *std::get_if<0>( &m_storage ); }
+        auto error() const noexcept -> E const& { return *std::get_if<1>( &m_storage ); }
+
+        // Found by ADL, so visit( visitor, parse_int4( "7" ) ) works just as std::visit does for variants
+        template<typename Visitor>
+        friend decltype(auto) visit( Visitor&& visitor, Expected const& expected ) {
+            return std::visit( std::forward<Visitor>( visitor ), expected.m_storage );
+        }
+    };
+
+    // The parse_int family, from the talk (see string_conversions.cpp)
+    [[nodiscard]] auto parse_int1( std::string_view sv, int& result ) -> bool;
+    auto parse_int2( std::string_view sv ) -> std::optional<int>;
+    auto parse_int3( std::string_view sv ) -> std::variant<int, std::domain_error>;
+    auto parse_int4( std::string_view sv ) -> Expected<int, ParseError>;
+
+    [[nodiscard]] auto parse_int1( std::string_view sv, int& result, int base ) -> bool;
+    auto parse_int2( std::string_view sv, int base ) -> std::optional<int>;
+    auto parse_int3( std::string_view sv, int base ) -> std::variant<int, std::domain_error>;
+
+    // Floating point companions. These sit on std::from_chars/to_chars, which are locale independent
+    // and exact: parsing is correctly rounded (libstdc++ and MSVC use the Eisel-Lemire fast path, with a fallback)
+    // and formatting gives the shortest text that reads back to the same double (Ryu)
+
+    // Whole string must be a number, e.g. "3.14", "-1e-7", "inf" - no leading '+' or whitespace
+    auto parse_double( std::string_view sv, double& value ) -> std::errc;
+    auto parse_double( std::string_view sv ) -> std::optional<double>;
+
+    // Longest possible output, e.g. "-2.2250738585072014e-308"
+    constexpr std::size_t maxDoubleChars = 24;
+
+    // Writes into [first, last) and returns one past the end of what was written (no terminator),
+    // or nullptr if it doesn't fit - maxDoubleChars is always enough
+    auto format_double( double value, char* first, char* last ) -> char*;
+    auto format_double( double value ) -> std::string;
+
+    // Batch parsing of delimited integer columns, e.g. "1,1,2,3,5,8" or one number per line
+
+    struct ParseFailure {
+        std::size_t index;  // which token (also its slot in ParsedInts::values)
+        std::size_t offset; // byte offset of the token in the buffer
+        std::errc ec;       // same codes as parse_integer
+    };
+
+    struct ParsedInts {
+        std::vector<int> values;            // one per token - failed tokens hold 0
+        std::vector<ParseFailure> failures; // in token order
+    };
+
+    // Appends to out. A delimiter ends a token, so "1,2," is two tokens, but "1,,2" has an empty (failing) one.
+    // Every level gives exactly the same results - asking for more than the CPU has falls back to what it does have
+    void parse_ints( std::string_view buffer, char delimiter, ParsedInts& out );
+    void parse_ints( std::string_view buffer, char delimiter, ParsedInts& out, SimdLevel level );
+
+    // Same results as parse_ints over the whole file, but the file is memory mapped (not read into a buffer)
+    // and split, on delimiters, into one chunk per thread (0 threads means one per core - and a small file
+    // gets fewer, no more than one per 4KB).
+    // Failure offsets are from the start of the file.
+    // Throws std::runtime_error if the file can't be opened or mapped - a std::system_error, with the OS's reason,
+    // where it's memory mapped
+    auto parse_ints_from_file( std::string const& path, char delimiter = '\n', unsigned threads = 0 ) -> ParsedInts;
+
+    // Columnar results - dense values plus a packed validity bitmap (one bit per value, like Apache Arrow)
+    // rather than vector<optional<int>>, which takes 8 bytes per 4 byte int.
+    // Nulls hold 0 in values(), so a plain sum over values() is already the sum of the valid ones
+
+    class IntColumn {
+        std::vector<int> m_values;
+        std::vector<std::uint64_t> m_validity; // bits past size() are always 0
+
+        static auto popcount( std::uint64_t word ) -> unsigned {
+#if defined( __GNUC__ ) || defined( __clang__ )
+            return static_cast<unsigned>( __builtin_popcountll( word ) );
+#else
+            unsigned count = 0;
+            for(; word != 0; word &= word - 1 )
+                ++count;
+            return count;
+#endif
+        }
+        static auto lowest_bit( std::uint64_t word ) -> unsigned {
+#if defined( __GNUC__ ) || defined( __clang__ )
+            return static_cast<unsigned>( __builtin_ctzll( word ) );
+#else
+            unsigned bit = 0;
+            for(; ( word & 1 ) == 0; word >>= 1 )
+                ++bit;
+            return bit;
+#endif
+        }
+
+    public:
+        IntColumn() = default;
+
+        // Takes over the values of a batch parse - only the bitmap is built
+        explicit IntColumn( ParsedInts&& parsed )
+        :   m_values( std::move( parsed.values ) ),
+            m_validity( ( m_values.size() + 63 ) / 64, ~std::uint64_t( 0 ) )
+        {
+            if( m_values.size() % 64 != 0 )
+                m_validity.back() = ( std::uint64_t( 1 ) << ( m_values.size() % 64 ) ) - 1;
+            for( auto const& failure : parsed.failures )
+                m_validity[failure.index / 64] &= ~( std::uint64_t( 1 ) << ( failure.index % 64 ) );
+        }
+
+        void reserve( std::size_t size ) {
+            m_values.reserve( size );
+            m_validity.reserve( ( size + 63 ) / 64 );
+        }
+        void push_back( int value ) {
+            if( m_values.size() % 64 == 0 )
+                m_validity.push_back( 0 );
+            m_validity.back() |= std::uint64_t( 1 ) << ( m_values.size() % 64 );
+            m_values.push_back( value );
+        }
+        void push_null() {
+            if( m_values.size() % 64 == 0 )
+                m_validity.push_back( 0 );
+            m_values.push_back( 0 );
+        }
+
+        auto size() const noexcept -> std::size_t { return m_values.size(); }
+        auto is_valid( std::size_t i ) const -> bool { return ( m_validity[i / 64] >> ( i % 64 ) ) & 1; }
+        auto get( std::size_t i ) const -> std::optional<int> {
+            if( is_valid( i ) )
+                return m_values[i];
+            return {};
+        }
+
+        auto values() const noexcept -> std::vector<int> const& { return m_values; }
+        auto validity() const noexcept -> std::vector<std::uint64_t> const& { return m_validity; }
+
+        // Counted from the bitmap, a word at a time (the compiler can vectorise this)
+        auto null_count() const -> std::size_t {
+            std::size_t valid = 0;
+            for( auto word : m_validity )
+                valid += popcount( word );
+            return m_values.size() - valid;
+        }
+
+        // f( index, value ) for each valid entry - all-null words are skipped in one go
+        template<typename F>
+        void for_each_valid( F&& f ) const {
+            for( std::size_t w = 0; w < m_validity.size(); ++w ) {
+                for( auto word = m_validity[w]; word != 0; word &= word - 1 ) {
+                    auto i = w * 64 + lowest_bit( word );
+                    f( i, m_values[i] );
+                }
+            }
+        }
+    };
+
+    // Bulk forms of parse_int2 - straight from a delimited buffer, or from a range of strings
+    auto parse_int_column( std::string_view buffer, char delimiter ) -> IntColumn;
+
+    template<typename Range>
+    auto parse_int_column( Range const& strings ) -> IntColumn {
+        IntColumn column;
+        column.reserve( std::size( strings ) );
+        for( auto const& s : strings ) {
+            int value;
+            if( parse_integer( std::string_view( s ), value ) == std::errc() )
+                column.push_back( value );
+            else
+                column.push_null();
+        }
+        return column;
+    }
+
+    // Incremental parsing of delimited ints that arrive in arbitrary chunks (e.g. off the network).
+    // A number split across chunks is carried over in a few bytes of fixed state:
+    // we only keep the sign and the significant digits, or the error, once the outcome is already decided.
+    // Results are exactly what parse_ints would give for the concatenated input.
+
+    struct StreamedInt {
+        int value;            // 0 if the token failed to parse
+        std::errc ec;         // same codes as parse_integer
+        std::uint64_t offset; // of the token, from the start of the stream
+    };
+
+    class StreamingIntParser {
+        static constexpr std::size_t maxDigits = std::numeric_limits<int>::digits10 + 1;
+
+        char m_delimiter;
+        char m_partial[maxDigits + 2]; // optional '-', then significant digits
+        unsigned char m_length = 0;
+        unsigned char m_digits = 0;
+        bool m_inToken = false;        // a token is being carried over from an earlier chunk
+        std::errc m_decided{};         // set once the carried token can only fail
+        std::uint64_t m_tokenOffset = 0;
+        std::uint64_t m_consumed = 0;
+
+        void carry( char const* first, char const* last ) {
+            for( char const* p = first; p != last && m_decided == std::errc(); ++p ) {
+                char c = *p;
+                if( c == '-' && m_length == 0 ) {
+                    m_partial[m_length++] = c;
+                }
+                else if( c >= '0' && c <= '9' ) {
+                    if( m_digits == 1 && m_partial[m_length-1] == '0' ) {
+                        m_partial[m_length-1] = c; // drop leading zeros
+                    }
+                    else if( m_digits == maxDigits ) {
+                        m_decided = std::errc::result_out_of_range; // too many significant digits, whatever follows
+                    }
+                    else {
+                        m_partial[m_length++] = c;
+                        ++m_digits;
+                    }
+                }
+                else {
+                    // End of the leading digits - anything after this makes it an error,
+                    // but which one depends on the digits we have so far
+                    int ignored;
+                    m_decided = parse_integer( std::string_view( m_partial, m_length ), ignored ) == std::errc::result_out_of_range
+                        ? std::errc::result_out_of_range
+                        : std::errc::invalid_argument;
+                }
+            }
+        }
+
+        auto take_carried() -> StreamedInt {
+            StreamedInt result{ 0, m_decided, m_tokenOffset };
+            if( result.ec == std::errc() )
+                result.ec = parse_integer( std::string_view( m_partial, m_length ), result.value );
+            if( result.ec != std::errc() )
+                result.value = 0;
+            m_inToken = false;
+            m_length = m_digits = 0;
+            m_decided = std::errc();
+            return result;
+        }
+
+    public:
+        explicit StreamingIntParser( char delimiter = '\n' ) : m_delimiter( delimiter ) {}
+
+        // Calls onInt( StreamedInt ) for every token completed by this chunk. Never allocates
+        template<typename Callback>
+        void feed( std::string_view chunk, Callback&& onInt ) {
+            char const* p = chunk.data();
+            char const* const end = p + chunk.size();
+
+            if( m_inToken ) {
+                auto delim = static_cast<char const*>( std::memchr( p, m_delimiter, chunk.size() ) );
+                if( !delim ) {
+                    carry( p, end );
+                    m_consumed += chunk.size();
+                    return;
+                }
+                carry( p, delim );
+                onInt( take_carried() );
+                p = delim + 1;
+            }
+
+            // Whole tokens go straight to the parser
+            while( auto delim = static_cast<char const*>( std::memchr( p, m_delimiter, static_cast<std::size_t>( end - p ) ) ) ) {
+                StreamedInt result{ 0, std::errc(), m_consumed + static_cast<std::uint64_t>( p - chunk.data() ) };
+                result.ec = parse_integer( std::string_view( p, static_cast<std::size_t>( delim - p ) ), result.value );
+                if( result.ec != std::errc() )
+                    result.value = 0;
+                onInt( result );
+                p = delim + 1;
+            }
+
+            if( p != end ) {
+                m_inToken = true;
+                m_tokenOffset = m_consumed + static_cast<std::uint64_t>( p - chunk.data() );
+                carry( p, end );
+            }
+            m_consumed += chunk.size();
+        }
+
+        // End of input - the last token doesn't need a delimiter after it
+        template<typename Callback>
+        void finish( Callback&& onInt ) {
+            if( m_inToken )
+                onInt( take_carried() );
+        }
+    };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Cpp17 {
+
+    // The strings being checked, without copying them. Catch prints the argument of a failed REQUIRE_THAT
+    // in full, so for big results pass one of these - it prints as just its size, e.g.
+    //     REQUIRE_THAT( StringsView( strings ), StringsEqual( expected ) );
+    // (the matcher also takes the vector itself, for when printing it all is fine)
+    class StringsView {
+        std::string const* m_first;
+        std::size_t m_size;
+    public:
+        StringsView( std::vector<std::string> const& strings ) : m_first( strings.data() ), m_size( strings.size() ) {}
+
+        auto size() const noexcept -> std::size_t { return m_size; }
+        auto operator[]( std::size_t i ) const -> std::string const& { return m_first[i]; }
+    };
+
+    // Like Catch's Equals( std::vector<std::string> ), but for big vectors:
+    // compares sizes, then each string's length before its chars (with memcmp), and on failure
+    // describes only a few strings either side of the first difference, instead of both vectors in full
+    class StringsEqualMatcher : public Catch::MatcherBase<StringsView> {
+        static constexpr std::size_t window = 3;    // strings shown either side of the first difference
+        static constexpr std::size_t maxChars = 40; // of each one
+
+        std::vector<std::string> const& m_expected;
+        mutable std::size_t m_actualSize = 0;
+        mutable std::size_t m_mismatch = 0;
+        mutable std::vector<std::string> m_actualWindow; // copied on failure - the actual strings are gone by the time we describe them
+
+        static auto quoted( std::string const& s ) -> std::string {
+            if( s.size() <= maxChars )
+                return '"' + s + '"';
+            return '"' + s.substr( 0, maxChars ) + "\"... (" + std::to_string( s.size() ) + " chars)";
+        }
+
+        auto first_mismatch( StringsView actual ) const -> std::size_t {
+            std::size_t const common = std::min( actual.size(), m_expected.size() );
+            for( std::size_t i = 0; i < common; ++i ) {
+                auto const& a = actual[i];
+                auto const& e = m_expected[i];
+                if( a.size() != e.size() || std::memcmp( a.data(), e.data(), a.size() ) != 0 )
+                    return i;
+            }
+            return common;
+        }
+
+    public:
+        explicit StringsEqualMatcher( std::vector<std::string> const& expected ) : m_expected( expected ) {}
+
+        auto match( StringsView const& actual ) const -> bool override {
+            m_actualSize = actual.size();
+            // Sizes first - if they differ it's a failure whatever the strings are,
+            // and they're only compared to find where they start to differ, for describe()
+            bool const sameSize = actual.size() == m_expected.size();
+            m_mismatch = first_mismatch( actual );
+            if( sameSize && m_mismatch == actual.size() )
+                return true;
+
+            std::size_t const first = m_mismatch > window ? m_mismatch - window : 0;
+            m_actualWindow.clear();
+            for( std::size_t i = first; i < std::min( actual.size(), m_mismatch + window + 1 ); ++i )
+                m_actualWindow.push_back( actual[i] );
+            return false;
+        }
+
+        auto describe() const -> std::string override {
+            std::ostringstream os;
+            os << "equals " << m_expected.size() << " strings";
+            if( m_mismatch == m_actualSize && m_mismatch == m_expected.size() )
+                return os.str();
+
+            if( m_actualSize != m_expected.size() )
+                os << ", but there are " << m_actualSize;
+            os << "\nfirst difference at index " << m_mismatch << ":";
+            std::size_t const first = m_mismatch > window ? m_mismatch - window : 0;
+            for( std::size_t i = first; i <= m_mismatch + window; ++i ) {
+                bool const hasActual = i - first < m_actualWindow.size();
+                bool const hasExpected = i < m_expected.size();
+                if( !hasActual && !hasExpected )
+                    break;
+                os << "\n  " << ( i == m_mismatch ? "> " : "  " ) << "[" << i << "] "
+                   << ( hasActual ? quoted( m_actualWindow[i - first] ) : "(none)" )
+                   << ( hasActual && hasExpected && m_actualWindow[i - first] == m_expected[i] ? " == " : " != " )
+                   << ( hasExpected ? quoted( m_expected[i] ) : "(none)" );
+            }
+            return os.str();
+        }
+    };
+
+    inline auto StringsEqual( std::vector<std::string> const& expected ) -> StringsEqualMatcher {
+        return StringsEqualMatcher( expected );
+    }
+}
+
+namespace Catch {
+    template<>
+    struct StringMaker<Cpp17::StringsView> {
+        static auto convert( Cpp17::StringsView const& strings ) -> std::string {
+            return "{ " + std::to_string( strings.size() ) + " strings }";
+        }
+    };
+}
@@ -1,7 +1,18 @@
 #include "catch.hpp"
-
+#include "allocation_counter.h"
+#include "formatter.h"
+#include "inserters.h"
+#include "int_to_string.h"
+#include "string_column.h"
+#include "string_matchers.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <deque>
+#include <thread>
 #include <vector>
 #include <numeric>
+#include <random>
 #include <sstream>
 
 using namespace Catch::Matchers;
@@ -210,6 +221,702 @@ TEST_CASE( "Vector of ints to vector of string" ) {
 
             REQUIRE_THAT(stringFib, Equals(expected));
         }
+
+        SECTION("bulk conversion") {
+            // Sized once, up front, and written with a digit pair lookup table
+            auto stringFib = Cpp17::to_strings(fib);
+
+            REQUIRE_THAT(stringFib, Equals(expected));
+            REQUIRE(Cpp17::to_delimited_text(fib, ',') == "1,1,2,3,5,8");
+        }
+
+        SECTION("packed column") {
+            // One buffer for all the characters, plus one for the offsets
+            Cpp17::StringColumn stringFib;
+
+            std::transform(
+                    fib.begin(), fib.end(),
+                    std::back_inserter(stringFib),
+                    [](auto i) { return std::to_string(i); });
+
+            REQUIRE_THAT(stringFib, Equals(expected));
+            REQUIRE(Cpp17::to_string_column(fib) == expected);
+        }
+
+        SECTION("inline decimal strings") {
+            // Each one holds its chars itself - the only allocation is the vector's
+            std::vector<Cpp17::DecimalString<Cpp17::maxDecimalLength<int>>> stringFib;
+            stringFib.reserve(fib.size());
+
+            std::transform(
+                    fib.begin(), fib.end(),
+                    std::back_inserter(stringFib),
+                    [](auto i) { return Cpp17::to_decimal_string(i); });
+
+            REQUIRE(std::equal(stringFib.begin(), stringFib.end(), expected.begin(), expected.end()));
+        }
+
+        SECTION("stringstream style, one formatter per thread") {
+            // The C++98 loop, almost unchanged - but nothing is constructed (or imbued) each time round
+            std::vector<std::string> stringFib;
+            stringFib.reserve(fib.size());
+
+            for (auto i : fib) {
+                auto& ss = Cpp17::local_formatter();
+                ss << i;
+                stringFib.push_back(ss.str());
+            }
+
+            REQUIRE_THAT(stringFib, Equals(expected));
+        }
+
+        SECTION("transform_into (reserves for us)") {
+            std::vector<std::string> stringFib;
+
+            // Every element lands in the buffer that was there when the first one was made
+            std::string const* buffer = nullptr;
+            bool reallocated = false;
+            Cpp17::transform_into(stringFib, fib, [&](auto i) {
+                if (!buffer)
+                    buffer = stringFib.data();
+                reallocated |= stringFib.data() != buffer;
+                return std::to_string(i);
+            });
+
+            REQUIRE_THAT(stringFib, Equals(expected));
+            REQUIRE(stringFib.capacity() >= fib.size());
+            REQUIRE_FALSE(reallocated);
+            REQUIRE(stringFib.data() == buffer);
+        }
+
+        SECTION("prefix, formatted in one pass") {
+            std::vector<std::string> stringFib;
+            stringFib.reserve(fib.size());
+
+            std::string prefix = ":-) ";
+            std::transform(
+                    fib.begin(), fib.end(),
+                    std::back_inserter(stringFib),
+                    Cpp17::PrefixedDecimal(prefix));
+
+            std::vector prefixedExpected = {":-) 1"s, ":-) 1"s, ":-) 2"s, ":-) 3"s, ":-) 5"s, ":-) 8"s};
+            REQUIRE_THAT(stringFib, Equals(prefixedExpected));
+            REQUIRE(Cpp17::to_string_column(fib, Cpp17::PrefixedDecimal(prefix)) == prefixedExpected);
+        }
+    }
+
+}
+
+TEST_CASE( "Integer to decimal" ) {
+
+    using namespace Cpp17;
+
+    auto check = []( auto value ) {
+        char buffer[32];
+        auto end = write_decimal( buffer, value );
+        if( std::string( buffer, end ) != std::to_string( value ) || decimal_length( value ) != std::to_string( value ).size() )
+            FAIL( "Wrong conversion of " << std::to_string( value ) );
+    };
+
+    SECTION( "edge values" ) {
+        check( std::numeric_limits<int>::min() );
+        check( std::numeric_limits<int>::max() );
+        check( std::numeric_limits<std::int64_t>::min() );
+        check( std::numeric_limits<std::int64_t>::max() );
+        check( std::numeric_limits<std::uint64_t>::max() );
+        check( std::numeric_limits<std::uint8_t>::max() );
+        check( std::numeric_limits<std::int16_t>::min() );
+        check( 0 );
+        check( -1 );
+
+        // Either side of every power of ten
+        for( std::uint64_t p = 1; p <= 1000000000000000000ull; p *= 10 ) {
+            check( p - 1 );
+            check( p );
+            check( p + 1 );
+            check( -static_cast<std::int64_t>( p ) );
+        }
+    }
+
+    SECTION( "random values" ) {
+        std::mt19937_64 rng( 42 );
+        for( int i = 0; i < 10000; ++i ) {
+            auto bits = rng();
+            check( static_cast<int>( bits ) >> ( bits % 32 ) );
+            check( bits >> ( bits % 64 ) );
+        }
+    }
+
+    SECTION( "empty range" ) {
+        REQUIRE( to_strings( std::vector<int>() ).empty() );
+        REQUIRE( to_delimited_text( std::vector<int>(), ',' ).empty() );
+    }
+}
+
+TEST_CASE( "StringColumn" ) {
+
+    using namespace Cpp17;
+
+    std::vector<std::int64_t> values;
+    for( std::int64_t i = 0; i < 1000; ++i )
+        values.push_back( i * i * i * i * ( i % 2 ? 1 : -1 ) );
+
+    SECTION( "two allocations, however many strings" ) {
+        AllocationCounter allocations;
+        auto column = to_string_column( values );
+        REQUIRE( allocations.count() == 2 );
+
+        REQUIRE( column.size() == values.size() );
+        REQUIRE( column == to_strings( values ) );
+        REQUIRE( column.chars().size() == total_decimal_length( values.begin(), values.end() ) );
+
+        // 32 bit ints go through write_decimals, eight at a time - still just the two
+        std::vector<int> ints( values.begin(), values.end() );
+        AllocationCounter intAllocations;
+        auto intColumn = to_string_column( ints );
+        REQUIRE( intAllocations.count() == 2 );
+        REQUIRE( intColumn == to_strings( ints ) );
+    }
+
+    SECTION( "iterates as string_views" ) {
+        auto column = to_string_column( values );
+        std::size_t i = 0;
+        for( std::string_view s : column )
+            REQUIRE( s == std::to_string( values[i++] ) );
+        REQUIRE( i == values.size() );
+    }
+
+    SECTION( "empty strings" ) {
+        StringColumn column;
+        column.push_back( "" );
+        column.push_back( "Blakes7" );
+        column.push_back( "" );
+        REQUIRE_THAT( column, Equals( std::vector<std::string>{ "", "Blakes7", "" } ) );
+    }
+}
+
+TEST_CASE( "DecimalString" ) {
+
+    using namespace Cpp17;
+
+    static_assert( std::is_trivially_copyable_v<DecimalString<20>> );
+    static_assert( sizeof( to_decimal_string( std::int64_t() ) ) <= 24 );
+    static_assert( to_decimal_string( -1234 ) == "-1234" );
+    static_assert( maxDecimalLength<std::int8_t> == 4 );
+    REQUIRE( maxDecimalLength<std::int64_t> == std::to_string( std::numeric_limits<std::int64_t>::min() ).size() );
+    REQUIRE( maxDecimalLength<std::uint64_t> == std::to_string( std::numeric_limits<std::uint64_t>::max() ).size() );
+
+    SECTION( "64 bit values and prefixes, without the heap" ) {
+        AllocationCounter allocations;
+        auto big = to_decimal_string( std::numeric_limits<std::int64_t>::min() );
+        auto prefixed = to_decimal_string<32>( ":-) ", std::numeric_limits<std::uint64_t>::max() );
+        auto copy = big;
+        REQUIRE( allocations.count() == 0 );
+
+        REQUIRE( big == "-9223372036854775808" );
+        REQUIRE( copy == big );
+        REQUIRE( prefixed == ":-) 18446744073709551615" );
+        REQUIRE( prefixed.str() == ":-) " + std::to_string( std::numeric_limits<std::uint64_t>::max() ) );
+    }
+
+    SECTION( "too long for the capacity" ) {
+        REQUIRE_THROWS_AS( ( to_decimal_string<8>( ":-) ", 12345 ) ), std::length_error );
+        REQUIRE( ( to_decimal_string<8>( ":-) ", 1234 ) ) == ":-) 1234" );
+    }
+
+    SECTION( "empty" ) {
+        DecimalString<4> empty;
+        REQUIRE( empty.empty() );
+        REQUIRE( empty.view().empty() );
     }
+}
+
+TEST_CASE( "Prefixed formatting" ) {
+
+    using namespace Cpp17;
+
+    // Long enough that every result is past SSO
+    std::string const prefix = "Fibonacci number: ";
+    std::vector<int> values;
+    for( int i = 0; i < 1000; ++i )
+        values.push_back( i * 7919 * ( i % 2 ? 1 : -1 ) );
+
+    std::vector<std::string> expected;
+    for( int value : values )
+        expected.push_back( prefix + std::to_string( value ) );
+
+    SECTION( "at most one allocation per element" ) {
+        std::vector<std::string> strings;
+        strings.reserve( values.size() );
+        AllocationCounter allocations;
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), PrefixedDecimal( prefix ) );
+        REQUIRE( allocations.count() <= values.size() );
+        REQUIRE_THAT( strings, Equals( expected ) );
+    }
+
+    SECTION( "packed" ) {
+        AllocationCounter allocations;
+        auto column = to_string_column( values, PrefixedDecimal( prefix ) );
+        REQUIRE( allocations.count() == 2 );
+        REQUIRE( column == expected );
+    }
+
+    SECTION( "into caller's storage" ) {
+        PrefixedDecimal format( prefix );
+        char buffer[64];
+        char* end = format.write( buffer, std::numeric_limits<std::int64_t>::min() );
+        REQUIRE( std::string_view( buffer, static_cast<std::size_t>( end - buffer ) ) == prefix + "-9223372036854775808" );
+        REQUIRE( format.length( std::numeric_limits<std::int64_t>::min() ) == prefix.size() + 20 );
+    }
+}
+
+TEST_CASE( "Prefixed formatting - allocations", "[!benchmark]" ) {
+
+    std::string const prefix = "Fibonacci number: ";
+    std::vector<int> values( 100000 );
+    std::mt19937 rng( 9 );
+    for( auto& value : values )
+        value = static_cast<int>( rng() ) >> ( rng() % 31 );
+
+    // Per element, with the output already reserved
+    auto allocationsPerElement = [&]( auto&& convert ) {
+        std::vector<std::string> strings;
+        strings.reserve( values.size() );
+        AllocationCounter allocations;
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), convert );
+        return static_cast<double>( allocations.count() ) / static_cast<double>( values.size() );
+    };
+    auto concatenated = allocationsPerElement( [&prefix]( int i ) { return prefix + std::to_string( i ); } );
+    auto onePass = allocationsPerElement( Cpp17::PrefixedDecimal( prefix ) );
+    WARN( "Allocations per element: prefix + to_string: " << concatenated << ", PrefixedDecimal: " << onePass );
+    CHECK( onePass <= 1.0 );
+
+    BENCHMARK( "prefix + to_string" ) {
+        std::vector<std::string> strings;
+        strings.reserve( values.size() );
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), [&prefix]( int i ) { return prefix + std::to_string( i ); } );
+        return strings;
+    };
+    BENCHMARK( "PrefixedDecimal" ) {
+        std::vector<std::string> strings;
+        strings.reserve( values.size() );
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), Cpp17::PrefixedDecimal( prefix ) );
+        return strings;
+    };
+    BENCHMARK( "to_string_column with PrefixedDecimal" ) {
+        return Cpp17::to_string_column( values, Cpp17::PrefixedDecimal( prefix ) );
+    };
+}
+
+TEST_CASE( "Formatter" ) {
+
+    using namespace Cpp17;
 
+    SECTION( "same text as a stringstream" ) {
+        Formatter f;
+        std::ostringstream ss;
+        f << "Blakes" << 7 << ' ' << -12L << std::string( " x" ) << std::uint64_t( 18446744073709551615ull ) << true << std::string_view( "!" );
+        ss << "Blakes" << 7 << ' ' << -12L << std::string( " x" ) << std::uint64_t( 18446744073709551615ull ) << true << std::string_view( "!" );
+        REQUIRE( f.str() == ss.str() );
+    }
+
+    SECTION( "doubles round trip" ) {
+        Formatter f;
+        f << 0.1 << ',' << -2.5e-300 << ',' << 0.1f << ',' << 1.5L;
+        REQUIRE( f.view() == "0.1,-2.5e-300,0.1,1.5" );
+    }
+
+    SECTION( "char sized ints and pointers, as a stringstream has them" ) {
+        Formatter f;
+        std::ostringstream ss;
+        char mutableText[] = "text";
+        unsigned char const bytes[] = "bytes";
+        f << std::int8_t( 'A' ) << std::uint8_t( 'B' ) << static_cast<signed char>( 'C' ) << mutableText << bytes;
+        ss << std::int8_t( 'A' ) << std::uint8_t( 'B' ) << static_cast<signed char>( 'C' ) << mutableText << bytes;
+        REQUIRE( f.str() == ss.str() );
+
+        int value = 0;
+        auto address = [&]( auto pointer ) {
+            f.clear();
+            f << pointer;
+            return f.str();
+        };
+        char hex[2 * sizeof( void* ) + 1];
+        std::string const expected = "0x" + std::string( hex, std::to_chars( hex, hex + sizeof( hex ), reinterpret_cast<std::uintptr_t>( &value ), 16 ).ptr );
+        REQUIRE( address( &value ) == expected );
+        REQUIRE( address( static_cast<void const*>( &value ) ) == expected );
+        REQUIRE( address( static_cast<int*>( nullptr ) ) == "0" );
+#ifdef __GLIBCXX__
+        ss.str( "" );
+        ss << &value;
+        REQUIRE( address( &value ) == ss.str() );
+#endif
+    }
+
+    SECTION( "grows past the inline buffer, and keeps what it grew" ) {
+        Formatter f;
+        std::string expected;
+        for( int i = 0; i < 1000; ++i ) {
+            f << i << ',';
+            expected += std::to_string( i ) + ',';
+        }
+        REQUIRE( f.view() == expected );
+
+        auto capacity = f.capacity();
+        f.clear();
+        REQUIRE( f.size() == 0 );
+        REQUIRE( f.capacity() == capacity );
+
+        AllocationCounter allocations;
+        for( int i = 0; i < 1000; ++i )
+            f << i << ',';
+        REQUIRE( allocations.count() == 0 );
+        REQUIRE( f.view() == expected );
+    }
+
+    SECTION( "one per thread, cleared each time" ) {
+        auto& f = local_formatter();
+        f << 42;
+        REQUIRE( &local_formatter() == &f );
+        REQUIRE( f.size() == 0 );
+
+        Formatter* other = nullptr;
+        std::thread( [&] { other = &local_formatter(); } ).join();
+        REQUIRE( other != &f );
+    }
+}
+
+TEST_CASE( "Sized inserters" ) {
+
+    using namespace Cpp17;
+
+    std::vector<int> values( 1000 );
+    std::iota( values.begin(), values.end(), -500 );
+    auto convert = []( int i ) { return to_decimal_string( i ); };
+
+    SECTION( "vector - one allocation" ) {
+        std::vector<DecimalString<maxDecimalLength<int>>> strings;
+        AllocationCounter allocations;
+        transform_into( strings, values, convert );
+        REQUIRE( allocations.count() == 1 );
+        REQUIRE( strings.size() == values.size() );
+        REQUIRE( strings.back() == "499" );
+    }
+
+    SECTION( "string" ) {
+        std::string digits;
+        transform_into( digits, values, []( int i ) { return static_cast<char>( '0' + ( i + 500 ) % 10 ); } );
+        REQUIRE( digits.size() == values.size() );
+        REQUIRE( digits.substr( 0, 12 ) == "012345678901" );
+    }
+
+    SECTION( "deque, which has nothing to reserve" ) {
+        std::deque<std::string> strings;
+        transform_into( strings, values, []( int i ) { return std::to_string( i ); } );
+        REQUIRE( strings.size() == values.size() );
+        REQUIRE( strings.front() == "-500" );
+    }
+
+    SECTION( "a single pass range can't be sized" ) {
+        std::istringstream in( "1 1 2 3 5 8" );
+        struct Words {
+            std::istream& in;
+            auto begin() const { return std::istream_iterator<std::string>( in ); }
+            auto end() const { return std::istream_iterator<std::string>(); }
+        };
+        REQUIRE( size_if_known( Words{ in } ) == 0 );
+
+        std::vector<std::string> strings;
+        transform_into( strings, Words{ in }, []( std::string const& s ) { return s; } );
+        REQUIRE_THAT( strings, Equals( std::vector<std::string>{ "1", "1", "2", "3", "5", "8" } ) );
+    }
+
+    SECTION( "a bit at a time still grows geometrically" ) {
+        std::vector<int> copies;
+        AllocationCounter allocations;
+        for( int i : values )
+            transform_into( copies, std::vector<int>{ i }, []( int x ) { return x; } ); // one allocation for each temporary vector
+        REQUIRE( allocations.count() - values.size() <= 11 );
+        REQUIRE( copies == values );
+    }
+}
+
+TEST_CASE( "Sized inserters - allocations", "[!benchmark]" ) {
+
+    std::vector<int> values( 100000 );
+    std::iota( values.begin(), values.end(), 0 );
+    auto convert = []( int i ) { return Cpp17::to_decimal_string( i ); };
+    using Strings = std::vector<Cpp17::DecimalString<Cpp17::maxDecimalLength<int>>>;
+
+    {
+        Strings strings;
+        AllocationCounter unreserved;
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), convert );
+        auto backInserter = unreserved.count();
+
+        Strings sized;
+        AllocationCounter reserved;
+        Cpp17::transform_into( sized, values, convert );
+        WARN( "Allocations for " << values.size() << " elements: back_inserter: " << backInserter << ", transform_into: " << reserved.count() );
+        CHECK( reserved.count() == 1 );
+    }
+
+    BENCHMARK( "std::back_inserter" ) {
+        Strings strings;
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), convert );
+        return strings;
+    };
+    BENCHMARK( "Cpp17::transform_into" ) {
+        Strings strings;
+        return Cpp17::transform_into( strings, values, convert ).size();
+    };
+    BENCHMARK( "std::back_inserter, std::string" ) {
+        std::vector<std::string> strings;
+        std::transform( values.begin(), values.end(), std::back_inserter( strings ), []( int i ) { return std::to_string( i ); } );
+        return strings;
+    };
+    BENCHMARK( "Cpp17::transform_into, std::string" ) {
+        std::vector<std::string> strings;
+        Cpp17::transform_into( strings, values, []( int i ) { return std::to_string( i ); } );
+        return strings;
+    };
+}
+
+TEST_CASE( "StringsEqual matcher" ) {
+
+    using namespace Cpp17;
+
+    std::vector<std::string> expected;
+    for( int i = 0; i < 1000000; ++i )
+        expected.push_back( std::to_string( i ) );
+    auto actual = expected;
+
+    SECTION( "equal" ) {
+        REQUIRE_THAT( StringsView( actual ), StringsEqual( expected ) );
+        REQUIRE_THAT( actual, StringsEqual( expected ) );
+        REQUIRE_THAT( std::vector<std::string>(), StringsEqual( std::vector<std::string>() ) );
+    }
+
+    SECTION( "a difference is described with just the strings around it" ) {
+        actual[500000] = "500001";
+        auto matcher = StringsEqual( expected );
+        REQUIRE_FALSE( matcher.match( actual ) );
+
+        auto description = matcher.describe();
+        REQUIRE_THAT( description, Contains( "first difference at index 500000" ) );
+        REQUIRE_THAT( description, Contains( "> [500000] \"500001\" != \"500000\"" ) );
+        REQUIRE_THAT( description, Contains( "[499997] \"499997\" == \"499997\"" ) );
+        REQUIRE_THAT( description, Contains( "[500003]" ) );
+        REQUIRE_THAT( description, !Contains( "[500004]" ) && !Contains( "[499996]" ) );
+        REQUIRE( description.size() < 500 );
+
+        REQUIRE( Catch::Detail::stringify( StringsView( actual ) ) == "{ 1000000 strings }" );
+    }
+
+    SECTION( "same chars, different lengths" ) {
+        actual[7] = "7 ";
+        REQUIRE_FALSE( StringsEqual( expected ).match( actual ) );
+    }
+
+    SECTION( "different sizes" ) {
+        actual.pop_back();
+        auto matcher = StringsEqual( expected );
+        REQUIRE_FALSE( matcher.match( actual ) );
+        auto description = matcher.describe();
+        REQUIRE_THAT( description, Contains( "but there are 999999" ) );
+        REQUIRE_THAT( description, Contains( "> [999999] (none) != \"999999\"" ) );
+    }
+
+    SECTION( "long strings are cut short" ) {
+        std::vector<std::string> longExpected = { std::string( 1000, 'x' ) };
+        std::vector<std::string> longActual = { std::string( 999, 'x' ) + 'y' };
+        auto matcher = StringsEqual( longExpected );
+        REQUIRE_FALSE( matcher.match( longActual ) );
+        REQUIRE_THAT( matcher.describe(), Contains( "... (1000 chars)" ) );
+        REQUIRE( matcher.describe().size() < 200 );
+    }
+}
+
+TEST_CASE( "StringsEqual matcher - speed", "[!benchmark]" ) {
+
+    std::vector<std::string> expected;
+    for( int i = 0; i < 1000000; ++i )
+        expected.push_back( ":-) " + std::to_string( i ) );
+    auto same = expected;
+    auto actual = expected;
+    actual.back() = "different";
+
+    BENCHMARK( "Equals, match" ) {
+        return Equals( expected ).match( same );
+    };
+    BENCHMARK( "StringsEqual, match" ) {
+        return Cpp17::StringsEqual( expected ).match( same );
+    };
+    BENCHMARK( "Equals, failure message" ) {
+        auto matcher = Equals( expected );
+        return matcher.match( actual ) ? std::string() : Catch::Detail::stringify( actual ) + matcher.toString();
+    };
+    BENCHMARK( "StringsEqual, failure message" ) {
+        auto matcher = Cpp17::StringsEqual( expected );
+        return matcher.match( actual ) ? std::string() : Catch::Detail::stringify( Cpp17::StringsView( actual ) ) + matcher.toString();
+    };
+}
+
+TEST_CASE( "Parallel conversion" ) {
+
+    using namespace Cpp17;
+
+    std::vector<int> values;
+    std::mt19937 rng( 3 );
+    for( int i = 0; i < 10007; ++i )
+        values.push_back( static_cast<int>( rng() ) >> ( rng() % 31 ) );
+
+    for( unsigned threads : { 1u, 2u, 3u, 8u, 0u } )
+        REQUIRE( to_string_column_parallel( values, threads ) == to_strings( values ) );
+
+    REQUIRE( to_string_column_parallel( std::vector<int>{ 1, 1, 2 }, 8 ) == std::vector<std::string>{ "1", "1", "2" } );
+    REQUIRE( to_string_column_parallel( std::vector<int>(), 4 ).empty() );
+}
+
+TEST_CASE( "64 bit values to strings - speed", "[!benchmark]" ) {
+
+    // Mostly past the SSO limit as std::strings (15 chars in libstdc++ and MSVC, 22 in libc++)
+    std::vector<std::int64_t> values;
+    std::mt19937_64 rng( 7 );
+    for( int i = 0; i < 100000; ++i )
+        values.push_back( static_cast<std::int64_t>( rng() ) );
+
+    BENCHMARK( "to_string" ) {
+        std::vector<std::string> strings;
+        strings.reserve( values.size() );
+        for( auto value : values )
+            strings.push_back( std::to_string( value ) );
+        return strings;
+    };
+    BENCHMARK( "to_decimal_string" ) {
+        std::vector<Cpp17::DecimalString<Cpp17::maxDecimalLength<std::int64_t>>> strings;
+        strings.reserve( values.size() );
+        for( auto value : values )
+            strings.push_back( Cpp17::to_decimal_string( value ) );
+        return strings;
+    };
+}
+
+TEST_CASE( "Parallel conversion - scaling", "[!benchmark]" ) {
+
+    // 10^6 and 10^7 by default - set GRANDPARENT_SCALING_MAX (e.g. to 1000000000) to go further,
+    // if you have the memory (about 20 bytes per int)
+    std::size_t maxCount = 10000000;
+    if( auto env = std::getenv( "GRANDPARENT_SCALING_MAX" ) )
+        maxCount = std::strtoull( env, nullptr, 10 );
+
+    unsigned cores = std::max( 1u, std::thread::hardware_concurrency() );
+
+    for( std::size_t count = 1000000; count <= maxCount; count *= 10 ) {
+        std::vector<int> values( count );
+        std::mt19937 rng( 5 );
+        for( auto& value : values )
+            value = static_cast<int>( rng() ) >> ( rng() % 31 );
+
+        for( unsigned threads = 1; threads <= cores; threads = threads < cores ? std::min( threads * 2, cores ) : cores + 1 ) {
+            BENCHMARK( std::to_string( count ) + " ints, " + std::to_string( threads ) + " threads" ) {
+                return Cpp17::to_string_column_parallel( values, threads ).size();
+            };
+        }
+    }
+}
+
+TEST_CASE( "Vector of ints to vector of string - speed", "[!benchmark]" ) {
+
+    // Lots of values of all sizes - not just six small ones
+    std::vector<int> fib;
+    std::mt19937 rng( 1 );
+    for( int i = 0; i < 100000; ++i )
+        fib.push_back( static_cast<int>( rng() ) >> ( rng() % 31 ) );
+
+    BENCHMARK( "C++98 stringstream loop" ) {
+        std::vector<std::string> stringFib;
+        stringFib.reserve( fib.size() );
+        for( std::vector<int>::const_iterator it = fib.begin(); it != fib.end(); ++it ) {
+            std::stringstream ss;
+            ss << *it;
+            stringFib.push_back( ss.str() );
+        }
+        return stringFib;
+    };
+    BENCHMARK( "stringstream, outside the loop, cleared each time" ) {
+        std::vector<std::string> stringFib;
+        stringFib.reserve( fib.size() );
+        std::stringstream ss;
+        for( int i : fib ) {
+            ss.str( std::string() );
+            ss.clear();
+            ss << i;
+            stringFib.push_back( ss.str() );
+        }
+        return stringFib;
+    };
+    BENCHMARK( "Cpp17::local_formatter" ) {
+        std::vector<std::string> stringFib;
+        stringFib.reserve( fib.size() );
+        for( int i : fib ) {
+            auto& ss = Cpp17::local_formatter();
+            ss << i;
+            stringFib.push_back( ss.str() );
+        }
+        return stringFib;
+    };
+    BENCHMARK( "to_string, reserved" ) {
+        std::vector<std::string> stringFib;
+        stringFib.reserve( fib.size() );
+        for( int i : fib )
+            stringFib.push_back( std::to_string( i ) );
+        return stringFib;
+    };
+    BENCHMARK( "to_string, not reserved" ) {
+        std::vector<std::string> stringFib;
+        for( int i : fib )
+            stringFib.push_back( std::to_string( i ) );
+        return stringFib;
+    };
+    BENCHMARK( "transform, back_inserter, lambda" ) {
+        std::vector<std::string> stringFib;
+        std::transform( fib.begin(), fib.end(), std::back_inserter( stringFib ), []( auto i ) { return std::to_string( i ); } );
+        return stringFib;
+    };
+    BENCHMARK( "transform, back_inserter, lambda with captures" ) {
+        std::vector<std::string> stringFib;
+        std::string prefix = ":-) ";
+        std::transform( fib.begin(), fib.end(), std::back_inserter( stringFib ), [prefix]( int i ) { return prefix + std::to_string( i ); } );
+        return stringFib;
+    };
+    BENCHMARK( "transform, back_inserter, to_decimal_string" ) {
+        std::vector<Cpp17::DecimalString<Cpp17::maxDecimalLength<int>>> stringFib;
+        std::transform( fib.begin(), fib.end(), std::back_inserter( stringFib ), []( auto i ) { return Cpp17::to_decimal_string( i ); } );
+        return stringFib;
+    };
+    BENCHMARK( "transform, back_inserter, to_decimal_string with prefix" ) {
+        std::vector<Cpp17::DecimalString<16>> stringFib;
+        std::string prefix = ":-) ";
+        std::transform( fib.begin(), fib.end(), std::back_inserter( stringFib ), [&prefix]( int i ) { return Cpp17::to_decimal_string<16>( prefix, i ); } );
+        return stringFib;
+    };
+    BENCHMARK( "Cpp17::to_strings" ) {
+        return Cpp17::to_strings( fib );
+    };
+    BENCHMARK( "Cpp17::to_string_column (two allocations)" ) {
+        return Cpp17::to_string_column( fib );
+    };
+    BENCHMARK( "Cpp17::to_delimited_text (one string)" ) {
+        return Cpp17::to_delimited_text( fib, ',' );
+    };
+
+    // The kernel behind to_string_column, at each level
+    std::string text( Cpp17::total_decimal_length( fib.begin(), fib.end() ), '\0' );
+    std::vector<std::size_t> ends( fib.size() );
+    for( auto [level, name] : { std::pair( Cpp17::SimdLevel::Scalar, "scalar" ), std::pair( Cpp17::SimdLevel::SSE2, "SSE2" ), std::pair( Cpp17::SimdLevel::AVX2, "AVX2" ) } ) {
+        BENCHMARK( std::string( "Cpp17::write_decimals, " ) + name ) {
+            return Cpp17::write_decimals( fib.data(), fib.size(), text.data(), ends.data(), 0, level );
+        };
+    }
 }